@@ -0,0 +1,178 @@
+/*
+  基准程序共用的堆分配计数: 替换全局 operator new / delete，统计开启计数的线程上的分配次数
+  - 普通 / 数组 / nothrow（C++17 起含对齐）形式的 new 都经 malloc 或 aligned_alloc 分配，
+    所有 delete 形式（含 sized）都经 free 释放，分配与释放成对
+  - 替换函数禁止内联: 内联后 GCC 会把 new 表达式与 free 配对检查，误报 -Wmismatched-new-delete
+  - 替换函数不能是 inline 函数，每个可执行文件只能有一个源文件包含本头文件
+------------------------------------------------------------------------------------------
+  alloc_counter::count_this_thread();   // 在被测线程上调用；或 count_all_threads() 统计所有线程
+  std::size_t before = alloc_counter::allocations();
+  ...
+  std::size_t n = alloc_counter::allocations() - before;
+------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if defined(__GNUC__)
+#define ALLOC_COUNTER_NOINLINE __attribute__((noinline))
+#else
+#define ALLOC_COUNTER_NOINLINE
+#endif
+
+namespace alloc_counter
+{
+std::atomic<std::size_t> g_allocations{0};
+std::atomic<bool> g_all_threads{false};
+thread_local bool t_counted = false;
+
+// 此后当前线程上的分配计入统计
+inline void count_this_thread()
+{
+  t_counted = true;
+}
+
+// 此后所有线程上的分配都计入统计
+inline void count_all_threads()
+{
+  g_all_threads.store(true);
+}
+
+// 已统计的分配次数
+inline std::size_t allocations()
+{
+  return g_allocations.load(std::memory_order_relaxed);
+}
+
+inline void* allocate(std::size_t size) noexcept
+{
+  if (t_counted || g_all_threads.load(std::memory_order_relaxed))
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+  return std::malloc(size ? size : 1);
+}
+
+#if defined(__cpp_aligned_new)
+inline void* allocate(std::size_t size, std::align_val_t alignment) noexcept
+{
+  if (t_counted || g_all_threads.load(std::memory_order_relaxed))
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+  // aligned_alloc 要求长度是对齐值的整数倍
+  std::size_t align = static_cast<std::size_t>(alignment);
+  std::size_t rounded = (size + align - 1) / align * align;
+  return std::aligned_alloc(align, rounded ? rounded : align);
+}
+#endif
+}  // namespace alloc_counter
+
+ALLOC_COUNTER_NOINLINE void* operator new(std::size_t size)
+{
+  if (void* p = alloc_counter::allocate(size)) return p;
+  throw std::bad_alloc();
+}
+
+ALLOC_COUNTER_NOINLINE void* operator new[](std::size_t size)
+{
+  if (void* p = alloc_counter::allocate(size)) return p;
+  throw std::bad_alloc();
+}
+
+ALLOC_COUNTER_NOINLINE void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+  return alloc_counter::allocate(size);
+}
+
+ALLOC_COUNTER_NOINLINE void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+  return alloc_counter::allocate(size);
+}
+
+ALLOC_COUNTER_NOINLINE void operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+ALLOC_COUNTER_NOINLINE void operator delete[](void* p) noexcept
+{
+  std::free(p);
+}
+
+ALLOC_COUNTER_NOINLINE void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+  std::free(p);
+}
+
+ALLOC_COUNTER_NOINLINE void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+  std::free(p);
+}
+
+#if defined(__cpp_sized_deallocation)
+ALLOC_COUNTER_NOINLINE void operator delete(void* p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+ALLOC_COUNTER_NOINLINE void operator delete[](void* p, std::size_t) noexcept
+{
+  std::free(p);
+}
+#endif
+
+#if defined(__cpp_aligned_new)
+ALLOC_COUNTER_NOINLINE void* operator new(std::size_t size, std::align_val_t alignment)
+{
+  if (void* p = alloc_counter::allocate(size, alignment)) return p;
+  throw std::bad_alloc();
+}
+
+ALLOC_COUNTER_NOINLINE void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+  if (void* p = alloc_counter::allocate(size, alignment)) return p;
+  throw std::bad_alloc();
+}
+
+ALLOC_COUNTER_NOINLINE void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+  return alloc_counter::allocate(size, alignment);
+}
+
+ALLOC_COUNTER_NOINLINE void* operator new[](std::size_t size, std::align_val_t alignment,
+                                            const std::nothrow_t&) noexcept
+{
+  return alloc_counter::allocate(size, alignment);
+}
+
+ALLOC_COUNTER_NOINLINE void operator delete(void* p, std::align_val_t) noexcept
+{
+  std::free(p);
+}
+
+ALLOC_COUNTER_NOINLINE void operator delete[](void* p, std::align_val_t) noexcept
+{
+  std::free(p);
+}
+
+ALLOC_COUNTER_NOINLINE void operator delete(void* p, std::size_t, std::align_val_t) noexcept
+{
+  std::free(p);
+}
+
+ALLOC_COUNTER_NOINLINE void operator delete[](void* p, std::size_t, std::align_val_t) noexcept
+{
+  std::free(p);
+}
+
+ALLOC_COUNTER_NOINLINE void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept
+{
+  std::free(p);
+}
+
+ALLOC_COUNTER_NOINLINE void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept
+{
+  std::free(p);
+}
+#endif
@@ -0,0 +1,179 @@
+/*
+  协程接口与回调接口的往返对比（需 -DASIOLEARN_CXX20=ON）
+  客户端与回环回显服务器之间做乒乓往返，统计吞吐以及稳定阶段每次往返的堆分配次数，
+  用于确认协程帧经由 asio 回收分配器分配后，开销不高于回调版本的 shared_from_this 捕获。
+  用法: coro_vs_callback [round_trips] [payload_size]
+*/
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+#include "alloc_counter.h"
+#include "network/coro_tcp_client.h"
+#include "network/tcp_client.h"
+
+using asio::ip::tcp;
+
+namespace
+{
+// 回显服务器: 收到什么回什么
+class EchoServer
+{
+ public:
+  explicit EchoServer(asio::io_context& io) : acceptor_(io, tcp::endpoint(asio::ip::address_v4::loopback(), 0))
+  {
+    start_accept();
+  }
+
+  std::string port() const
+  {
+    return std::to_string(acceptor_.local_endpoint().port());
+  }
+
+ private:
+  struct Session : std::enable_shared_from_this<Session>
+  {
+    explicit Session(tcp::socket s) : socket(std::move(s)) {}
+
+    void start()
+    {
+      auto self = shared_from_this();
+      socket.async_read_some(asio::buffer(buf), [self](std::error_code ec, std::size_t n) {
+        if (ec) return;
+        asio::async_write(self->socket, asio::buffer(self->buf, n), [self](std::error_code ec, std::size_t) {
+          if (!ec) self->start();
+        });
+      });
+    }
+
+    tcp::socket socket;
+    std::array<char, 65536> buf;
+  };
+
+  void start_accept()
+  {
+    acceptor_.async_accept([this](std::error_code ec, tcp::socket socket) {
+      if (!ec)
+      {
+        socket.set_option(tcp::no_delay(true));
+        std::make_shared<Session>(std::move(socket))->start();
+      }
+      start_accept();
+    });
+  }
+
+  tcp::acceptor acceptor_;
+};
+
+struct Result
+{
+  double seconds = 0;
+  double allocs_per_round_trip = 0;
+};
+
+void report(const char* name, int round_trips, const Result& r)
+{
+  std::cout << name << ": " << round_trips / r.seconds << " round trips/s, " << r.allocs_per_round_trip
+            << " heap allocations per round trip\n";
+}
+
+Result run_callback(const std::string& port, int round_trips, std::size_t payload_size)
+{
+  asio::io_context io;
+  TcpClient::Options options;
+  options.no_delay = true;
+  auto client = std::make_shared<TcpClient>(io, "127.0.0.1", port, options);
+  client->set_frame_codec(std::make_shared<LengthPrefixCodec>(LengthPrefixCodec::Prefix::U32));
+
+  std::string frame;
+  std::string payload(payload_size, 'x');
+  LengthPrefixCodec(LengthPrefixCodec::Prefix::U32).encode(payload.data(), payload.size(), frame);
+
+  // 前 10% 作为预热，不计入统计
+  const int warmup = round_trips / 10;
+  int done = 0;
+  std::size_t allocs_at_start = 0;
+  std::chrono::steady_clock::time_point start;
+  Result result;
+
+  client->set_message_view_callback([&](asio::const_buffer) {
+    ++done;
+    if (done == warmup)
+    {
+      allocs_at_start = alloc_counter::allocations();
+      start = std::chrono::steady_clock::now();
+    }
+    if (done == warmup + round_trips)
+    {
+      result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      result.allocs_per_round_trip = double(alloc_counter::allocations() - allocs_at_start) / round_trips;
+      client->stop();
+      io.stop();
+      return;
+    }
+    client->send(frame);
+  });
+  client->set_status_callback([&](TcpClient::Status s, const std::string&) {
+    if (s == TcpClient::Status::Connected) client->send(frame);
+  });
+
+  client->start();
+  io.run();
+  return result;
+}
+
+Result run_coroutine(const std::string& port, int round_trips, std::size_t payload_size)
+{
+  asio::io_context io;
+  Result result;
+
+  auto session = [&]() -> asio::awaitable<void> {
+    TcpClient::Options options;
+    options.no_delay = true;
+    CoroTcpClient client(io, "127.0.0.1", port, options);
+    client.set_frame_codec(std::make_shared<LengthPrefixCodec>(LengthPrefixCodec::Prefix::U32));
+    co_await client.connect();
+
+    std::string payload(payload_size, 'x');
+    const int warmup = round_trips / 10;
+    std::size_t allocs_at_start = 0;
+    std::chrono::steady_clock::time_point start;
+    for (int i = 0; i < warmup + round_trips; ++i)
+    {
+      if (i == warmup)
+      {
+        allocs_at_start = alloc_counter::allocations();
+        start = std::chrono::steady_clock::now();
+      }
+      co_await client.send_frame(payload);
+      co_await client.receive_frame();
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.allocs_per_round_trip = double(alloc_counter::allocations() - allocs_at_start) / round_trips;
+    client.close();
+  };
+
+  asio::co_spawn(io, session(), asio::detached);
+  io.run();
+  return result;
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  int round_trips = argc > 1 ? std::atoi(argv[1]) : 100000;
+  std::size_t payload_size = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 64;
+  alloc_counter::count_all_threads();  // 与服务器线程合计
+
+  asio::io_context server_io;
+  EchoServer server(server_io);
+  std::thread server_thread([&server_io] { server_io.run(); });
+
+  report("callback  (TcpClient)    ", round_trips, run_callback(server.port(), round_trips, payload_size));
+  report("coroutine (CoroTcpClient)", round_trips, run_coroutine(server.port(), round_trips, payload_size));
+
+  server_io.stop();
+  server_thread.join();
+}
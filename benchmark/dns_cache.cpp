@@ -0,0 +1,251 @@
+/*
+  DnsCache 行为检查: 用本地替身解析函数代替真实 DNS，记录底层解析次数，由本程序控制何时、以何结果完成
+    coalesce  : 同一 host:port 的并发请求（来自两个 io_context 和一个 strand）只触发一次底层解析，
+                每个请求的回调都在自己的 io_context / strand 上执行
+    hit       : TTL 内的再次请求直接命中缓存，不再解析
+    negative  : 解析失败的结果在负缓存 TTL 内同样命中缓存
+    aborted   : 被取消的解析（operation_aborted）不做负缓存，下次请求重新解析
+    expire    : TTL 为 0 时每次请求都重新解析
+    abandoned : 发起解析的 io_context 在解析完成前被销毁，另一个 io_context 之后仍能解析同一 host:port
+  任一检查失败时返回非 0。
+  用法: dns_cache
+*/
+
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "network/dns_cache.h"
+
+using asio::ip::tcp;
+
+namespace
+{
+const std::chrono::seconds kWait(2);  // 等待单个回调的上限
+
+// 替身解析函数: 记录每次调用，挂起的解析由 complete() 完成
+class StandInResolver
+{
+ public:
+  void install(DnsCache& cache)
+  {
+    cache.set_resolve_function([this](asio::io_context&, const std::string& host, const std::string& port,
+                                      DnsCache::Handler handler) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++calls_;
+      pending_.push_back(Pending{host, port, std::move(handler)});
+    });
+  }
+
+  int calls()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return calls_;
+  }
+
+  // 完成所有挂起的解析: 成功时返回 127.0.0.1:port
+  void complete(std::error_code ec)
+  {
+    std::vector<Pending> pending;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      pending.swap(pending_);
+    }
+    for (auto& p : pending)
+    {
+      DnsCache::Results results;
+      if (!ec)
+      {
+        tcp::endpoint endpoint(asio::ip::address_v4::loopback(), static_cast<unsigned short>(std::stoi(p.port)));
+        results = DnsCache::Results::create(endpoint, p.host, p.port);
+      }
+      p.handler(ec, results);
+    }
+  }
+
+ private:
+  struct Pending
+  {
+    std::string host;
+    std::string port;
+    DnsCache::Handler handler;
+  };
+
+  std::mutex mutex_;
+  int calls_ = 0;
+  std::vector<Pending> pending_;
+};
+
+// 一次请求的结果: 错误码、解析到的地址数、回调是否在预期的执行器上运行
+struct Outcome
+{
+  std::error_code ec;
+  std::size_t endpoints = 0;
+  bool on_executor = false;
+};
+
+using OutcomePromise = std::shared_ptr<std::promise<Outcome>>;
+
+// 发起一次请求，回调在 executor 上执行时记录 on_executor
+template <typename Executor>
+std::future<Outcome> request(DnsCache& cache, asio::io_context& io, const Executor& executor, const std::string& host,
+                             const std::string& port)
+{
+  OutcomePromise promise = std::make_shared<std::promise<Outcome>>();
+  std::future<Outcome> future = promise->get_future();
+  cache.async_resolve(io, executor, host, port, [promise, executor](std::error_code ec, DnsCache::Results results) {
+    Outcome outcome;
+    outcome.ec = ec;
+    outcome.endpoints = results.size();
+    outcome.on_executor = executor.running_in_this_thread();
+    promise->set_value(outcome);
+  });
+  return future;
+}
+
+bool ready(std::future<Outcome>& f)
+{
+  return f.wait_for(kWait) == std::future_status::ready;
+}
+
+bool check(const char* name, bool ok)
+{
+  std::cout << name << (ok ? " OK" : " FAIL") << "\n";
+  return ok;
+}
+
+// io_context 在独立线程上运行，直到析构
+class Runner
+{
+ public:
+  Runner() : guard_(asio::make_work_guard(io_)), thread_([this] { io_.run(); }) {}
+
+  ~Runner()
+  {
+    guard_.reset();
+    thread_.join();
+  }
+
+  asio::io_context& io()
+  {
+    return io_;
+  }
+
+ private:
+  asio::io_context io_{1};
+  asio::executor_work_guard<asio::io_context::executor_type> guard_;
+  std::thread thread_;
+};
+}  // namespace
+
+int main()
+{
+  bool ok = true;
+  Runner a, b;
+  auto strand = asio::make_strand(a.io());
+
+  {
+    auto cache = std::make_shared<DnsCache>(std::chrono::hours(1), std::chrono::hours(1));
+    StandInResolver resolver;
+    resolver.install(*cache);
+
+    // 并发请求合并为一次解析，各自在自己的执行器上完成
+    auto fa = request(*cache, a.io(), a.io().get_executor(), "svc.test", "80");
+    auto fb = request(*cache, b.io(), b.io().get_executor(), "svc.test", "80");
+    auto fs = request(*cache, a.io(), strand, "svc.test", "80");
+    bool single = resolver.calls() == 1;
+    resolver.complete(std::error_code());
+    bool done = ready(fa) && ready(fb) && ready(fs);
+    bool coalesced = single && done;
+    if (done)
+    {
+      Outcome oa = fa.get(), ob = fb.get(), os = fs.get();
+      coalesced = coalesced && !oa.ec && !ob.ec && !os.ec && oa.endpoints == 1 && ob.endpoints == 1;
+      ok = check("coalesce: one resolve for concurrent requests", coalesced) && ok;
+      ok = check("coalesce: each waiter completes on its own executor",
+                 oa.on_executor && ob.on_executor && os.on_executor) && ok;
+    }
+    else
+    {
+      ok = check("coalesce: one resolve for concurrent requests", false) && ok;
+    }
+
+    // TTL 内命中缓存
+    auto fh = request(*cache, b.io(), b.io().get_executor(), "svc.test", "80");
+    bool hit = ready(fh) && resolver.calls() == 1;
+    if (hit)
+    {
+      Outcome oh = fh.get();
+      hit = !oh.ec && oh.endpoints == 1 && oh.on_executor;
+    }
+    ok = check("hit: cached result within TTL", hit) && ok;
+
+    // 负缓存
+    auto fn1 = request(*cache, a.io(), a.io().get_executor(), "missing.test", "80");
+    resolver.complete(asio::error::host_not_found);
+    bool negative = ready(fn1) && fn1.get().ec == asio::error::host_not_found;
+    int calls = resolver.calls();
+    auto fn2 = request(*cache, a.io(), a.io().get_executor(), "missing.test", "80");
+    negative = negative && ready(fn2) && fn2.get().ec == asio::error::host_not_found && resolver.calls() == calls;
+    ok = check("negative: failure cached within negative TTL", negative) && ok;
+
+    // 被取消的解析不缓存
+    auto fc1 = request(*cache, a.io(), a.io().get_executor(), "cancel.test", "80");
+    resolver.complete(asio::error::operation_aborted);
+    bool aborted = ready(fc1) && fc1.get().ec == asio::error::operation_aborted;
+    calls = resolver.calls();
+    auto fc2 = request(*cache, a.io(), a.io().get_executor(), "cancel.test", "80");
+    aborted = aborted && resolver.calls() == calls + 1;
+    resolver.complete(std::error_code());
+    aborted = aborted && ready(fc2) && !fc2.get().ec;
+    ok = check("aborted: cancelled resolve is not negatively cached", aborted) && ok;
+  }
+
+  {
+    auto cache = std::make_shared<DnsCache>(std::chrono::seconds(0));
+    StandInResolver resolver;
+    resolver.install(*cache);
+    bool expire = true;
+    for (int i = 0; i < 3; ++i)
+    {
+      auto f = request(*cache, a.io(), a.io().get_executor(), "svc.test", "80");
+      resolver.complete(std::error_code());
+      expire = expire && ready(f) && !f.get().ec;
+    }
+    ok = check("expire: zero TTL resolves every time", expire && resolver.calls() == 3) && ok;
+  }
+
+  {
+    auto cache = std::make_shared<DnsCache>(std::chrono::hours(1));
+    int abandoned_calls = 0;
+    // 回调挂在发起解析的 io_context 的定时器上，io_context 销毁时随之被销毁而不被调用
+    cache->set_resolve_function([&abandoned_calls](asio::io_context& io, const std::string&, const std::string&,
+                                                   DnsCache::Handler handler) {
+      ++abandoned_calls;
+      auto timer = std::make_shared<asio::steady_timer>(io, std::chrono::hours(1));
+      timer->async_wait([timer, handler](std::error_code ec) { handler(ec, DnsCache::Results()); });
+    });
+    {
+      asio::io_context doomed(1);
+      request(*cache, doomed, doomed.get_executor(), "svc.test", "80");
+    }
+
+    StandInResolver resolver;
+    resolver.install(*cache);
+    auto f = request(*cache, b.io(), b.io().get_executor(), "svc.test", "80");
+    resolver.complete(std::error_code());
+    bool abandoned = abandoned_calls == 1 && resolver.calls() == 1 && ready(f);
+    if (abandoned)
+    {
+      Outcome o = f.get();
+      abandoned = !o.ec && o.endpoints == 1 && o.on_executor;
+    }
+    ok = check("abandoned: destroyed io_context does not wedge the entry", abandoned) && ok;
+  }
+
+  return ok ? 0 : 1;
+}
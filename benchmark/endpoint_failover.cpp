@@ -0,0 +1,155 @@
+/*
+  多端点故障转移与按延迟选路演示
+  两个回环回显服务器: slow 对每次读取延迟 delay_ms 后才回写（"慢但没死"），fast 立即回写。
+  客户端端点列表为 [slow, fast]，先连上 slow；每 20ms 发一个 PING 探测帧，slow 的 srtt 越过阈值后
+  客户端主动切换到 fast。随后关闭 fast，客户端出错后自动回到 slow，全程无需手动重启。
+  用法: endpoint_failover [delay_ms=20] [threshold_ms=5]
+*/
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "network/tcp_client.h"
+
+using asio::ip::tcp;
+
+namespace
+{
+// 回显服务器，每次读取到的数据延迟 delay 后原样回写
+class DelayEchoServer
+{
+ public:
+  DelayEchoServer(asio::io_context& io, std::chrono::milliseconds delay) :
+    acceptor_(io, tcp::endpoint(asio::ip::address_v4::loopback(), 0)), delay_(delay)
+  {
+    start_accept();
+  }
+
+  std::string port() const
+  {
+    return std::to_string(acceptor_.local_endpoint().port());
+  }
+
+  // 停止服务: 关闭监听和所有会话
+  void shutdown()
+  {
+    std::error_code ec;
+    acceptor_.close(ec);
+    for (auto& weak : sessions_)
+    {
+      if (auto s = weak.lock()) s->socket.close(ec);
+    }
+  }
+
+ private:
+  struct Session : std::enable_shared_from_this<Session>
+  {
+    Session(tcp::socket s, std::chrono::milliseconds d) : socket(std::move(s)), timer(socket.get_executor()), delay(d)
+    {
+    }
+
+    void start()
+    {
+      auto self = shared_from_this();
+      socket.async_read_some(asio::buffer(buf), [self](std::error_code ec, std::size_t n) {
+        if (ec) return;
+        self->timer.expires_after(self->delay);
+        self->timer.async_wait([self, n](std::error_code) {
+          asio::async_write(self->socket, asio::buffer(self->buf, n), [self](std::error_code ec, std::size_t) {
+            if (!ec) self->start();
+          });
+        });
+      });
+    }
+
+    tcp::socket socket;
+    asio::steady_timer timer;
+    std::chrono::milliseconds delay;
+    char buf[1024];
+  };
+
+  void start_accept()
+  {
+    acceptor_.async_accept([this](std::error_code ec, tcp::socket socket) {
+      if (ec) return;
+      auto session = std::make_shared<Session>(std::move(socket), delay_);
+      sessions_.push_back(session);
+      session->start();
+      start_accept();
+    });
+  }
+
+  tcp::acceptor acceptor_;
+  std::chrono::milliseconds delay_;
+  std::vector<std::weak_ptr<Session>> sessions_;
+};
+
+void print_stats(const TcpClient& client)
+{
+  for (const auto& st : client.endpoint_stats())
+  {
+    std::cout << "  " << (st.current ? "*" : " ") << " port " << st.endpoint.port << " srtt=" << st.srtt.count()
+              << "us samples=" << st.samples << " failures=" << st.failures << "\n";
+  }
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  std::chrono::milliseconds delay(argc > 1 ? std::atoi(argv[1]) : 20);
+  std::chrono::milliseconds threshold(argc > 2 ? std::atoi(argv[2]) : 5);
+
+  asio::io_context sio;
+  DelayEchoServer slow(sio, delay);
+  DelayEchoServer fast(sio, std::chrono::milliseconds(0));
+  auto work = asio::make_work_guard(sio);
+  std::thread st([&sio] { sio.run(); });
+
+  asio::io_context io;
+  auto client = std::make_shared<TcpClient>(io, "127.0.0.1", slow.port());
+  client->set_endpoints({{"127.0.0.1", slow.port()}, {"127.0.0.1", fast.port()}});
+  client->set_frame_codec(std::make_shared<DelimiterCodec>("\n"));
+  TcpClient::FailoverPolicy failover;
+  failover.rtt_threshold = threshold;
+  failover.ping_interval = std::chrono::milliseconds(20);
+  failover.ping_payload = "PING";
+  failover.is_pong = [](asio::const_buffer b) {
+    return std::string(static_cast<const char*>(b.data()), b.size()) == "PING";
+  };
+  client->set_failover_policy(failover);
+  TcpClient::ReconnectPolicy policy;
+  policy.base = std::chrono::milliseconds(50);
+  policy.max_delay = std::chrono::milliseconds(200);
+  client->set_reconnect_policy(policy);
+  client->set_status_callback(
+    [](TcpClient::Status, const std::string& info) { std::cout << "[status] " << info << "\n"; });
+  client->start();
+  std::thread t([&io] {
+    auto work = asio::make_work_guard(io);
+    io.run();
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+  std::cout << "after 1s (slow=" << slow.port() << " delay " << delay.count() << "ms, fast=" << fast.port() << "):\n";
+  print_stats(*client);
+
+  std::cout << "shutting down fast server\n";
+  asio::post(sio, [&fast] { fast.shutdown(); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+  std::cout << "after fast server went away:\n";
+  print_stats(*client);
+  std::cout << "failovers=" << client->metrics().failovers << " reconnects=" << client->metrics().reconnects << "\n";
+
+  client->stop();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  io.stop();
+  t.join();
+  work.reset();
+  sio.stop();
+  st.join();
+}
@@ -0,0 +1,190 @@
+/*
+  完成处理函数分配检查: 统计 TcpClient 稳态读写循环中客户端 io 线程上的堆分配次数。
+  只计入客户端 io 线程的分配（服务器运行在其它线程），分别检查不启用 / 启用 strand 两种配置:
+    read-stream : 服务器持续推送数据，客户端只读
+    ping-pong   : 客户端在回调里发送短消息（小字符串，无数据分配），服务器回显；
+                  发送队列节点由 asio 的线程级缓存回收，待发送队列为环形缓冲区
+  所有配置都断言处理函数内存池没有退回 operator new；不启用 strand 时额外断言两种循环都是 0 次堆分配。
+  启用 strand 且两个线程运行时，strand 的 invoker 和发送队列节点使用的 asio 线程级缓存是每线程的，
+  在一个线程上分配、在另一个线程上释放时无法复用，会落到 malloc（乒乓约每次往返一次），这部分只报告不断言。
+  任一断言失败时返回非 0。
+  用法: handler_alloc [iterations]
+*/
+
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "alloc_counter.h"
+#include "network/tcp_client.h"
+
+using asio::ip::tcp;
+
+namespace
+{
+const std::size_t kWarmup = 1000;
+
+// stream 模式持续推送固定数据，echo 模式原样回显
+class TestServer
+{
+ public:
+  TestServer(asio::io_context& io, bool stream) :
+    acceptor_(io, tcp::endpoint(asio::ip::address_v4::loopback(), 0)), stream_(stream)
+  {
+    start_accept();
+  }
+
+  std::string port() const
+  {
+    return std::to_string(acceptor_.local_endpoint().port());
+  }
+
+ private:
+  struct Session : std::enable_shared_from_this<Session>
+  {
+    explicit Session(tcp::socket s) : socket(std::move(s))
+    {
+      buf.fill('x');
+    }
+
+    void push()
+    {
+      auto self = shared_from_this();
+      asio::async_write(socket, asio::buffer(buf, 4096), [self](std::error_code ec, std::size_t) {
+        if (!ec) self->push();
+      });
+    }
+
+    void echo()
+    {
+      auto self = shared_from_this();
+      socket.async_read_some(asio::buffer(buf), [self](std::error_code ec, std::size_t n) {
+        if (ec) return;
+        asio::async_write(self->socket, asio::buffer(self->buf, n), [self](std::error_code ec, std::size_t) {
+          if (!ec) self->echo();
+        });
+      });
+    }
+
+    tcp::socket socket;
+    std::array<char, 65536> buf;
+  };
+
+  void start_accept()
+  {
+    acceptor_.async_accept([this](std::error_code ec, tcp::socket socket) {
+      if (ec) return;
+      auto session = std::make_shared<Session>(std::move(socket));
+      if (stream_)
+        session->push();
+      else
+        session->echo();
+      start_accept();
+    });
+  }
+
+  tcp::acceptor acceptor_;
+  bool stream_;
+};
+
+struct Result
+{
+  double allocations_per_op;
+  std::uint64_t fallbacks;
+};
+
+// 跑满 kWarmup + iterations 次回调，返回稳态阶段每次回调的分配次数和内存池退回次数
+Result run(bool stream, bool use_strand, std::size_t iterations)
+{
+  asio::io_context server_io;
+  TestServer server(server_io, stream);
+  std::thread server_thread([&server_io] { server_io.run(); });
+
+  asio::io_context io;
+  TcpClient::Options options;
+  options.use_strand = use_strand;
+  options.no_delay = true;
+  auto client = std::make_shared<TcpClient>(io, "127.0.0.1", server.port(), options);
+
+  std::size_t count = 0;
+  std::size_t alloc_begin = 0, alloc_end = 0;
+  std::uint64_t fallback_begin = 0, fallback_end = 0;
+  std::weak_ptr<TcpClient> weak = client;
+  auto on_op = [&, weak] {
+    ++count;
+    if (count == kWarmup)
+    {
+      alloc_begin = alloc_counter::allocations();
+      fallback_begin = weak.lock()->handler_fallbacks();
+    }
+    if (count == kWarmup + iterations)
+    {
+      alloc_end = alloc_counter::allocations();
+      fallback_end = weak.lock()->handler_fallbacks();
+      io.stop();
+    }
+  };
+
+  if (stream)
+  {
+    client->set_message_view_callback([&](asio::const_buffer) { on_op(); });
+  }
+  else
+  {
+    client->set_status_callback([weak](TcpClient::Status s, const std::string&) {
+      if (s == TcpClient::Status::Connected) weak.lock()->send(std::string("ping"));
+    });
+    client->set_message_view_callback([&, weak](asio::const_buffer) {
+      on_op();
+      if (auto self = weak.lock()) self->send(std::string("ping"));
+    });
+  }
+  client->start();
+
+  std::vector<std::thread> runners;
+  for (int i = 0; i < (use_strand ? 2 : 1); ++i)
+  {
+    runners.emplace_back([&io] {
+      alloc_counter::count_this_thread();  // 只统计客户端 io 线程上的堆分配
+      io.run();
+    });
+  }
+  for (auto& t : runners) t.join();
+
+  client.reset();
+  server_io.stop();
+  server_thread.join();
+
+  Result result;
+  result.allocations_per_op = static_cast<double>(alloc_end - alloc_begin) / iterations;
+  result.fallbacks = fallback_end - fallback_begin;
+  return result;
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  std::size_t iterations = argc > 1 ? static_cast<std::size_t>(std::atoi(argv[1])) : 20000;
+  bool ok = true;
+
+  for (bool use_strand : {false, true})
+  {
+    const char* mode = use_strand ? "strand" : "plain ";
+
+    Result read = run(true, use_strand, iterations);
+    bool read_ok = read.fallbacks == 0 && (use_strand || read.allocations_per_op == 0);
+    std::cout << mode << " read-stream: " << read.allocations_per_op << " allocs/read, " << read.fallbacks
+              << " pool fallbacks " << (read_ok ? "OK" : "FAIL") << "\n";
+
+    Result echo = run(false, use_strand, iterations);
+    bool echo_ok = echo.fallbacks == 0 && (use_strand || echo.allocations_per_op == 0);
+    std::cout << mode << " ping-pong  : " << echo.allocations_per_op << " allocs/round trip, " << echo.fallbacks
+              << " pool fallbacks " << (echo_ok ? "OK" : "FAIL") << "\n";
+
+    ok = ok && read_ok && echo_ok;
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,170 @@
+/*
+  竞速连接（Happy Eyeballs）回环验证: 解析结果的第一个地址永不应答，第二个地址是正常的回环服务器。
+  "永不应答"的地址是一个 backlog 为 0 且全连接队列已被占满的 IPv4 监听套接字，内核会直接丢弃后续 SYN；
+  服务器在可用时监听 IPv6 回环地址，模拟双栈主机上一个地址族被黑洞的情形，
+  竞速连接第一次胜出后会记住 IPv6，之后的重连不再等待错时间隔（无 IPv6 时两者同族，每次都要等一个间隔）。
+  分别用逐个尝试（asio::async_connect）和竞速连接各做若干次"连接 - 断开 - 重连"，统计每次连上所需时间；
+  逐个尝试会卡在首地址的 SYN 重传上，超过 deadline 仍未连上则记为超时。
+  用法: happy_eyeballs [rounds=3] [deadline_ms=3000]
+*/
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "network/tcp_client.h"
+
+using asio::ip::tcp;
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+// 占满全连接队列的监听套接字，之后到达的 SYN 都会被丢弃
+class BlackHole
+{
+ public:
+  explicit BlackHole(asio::io_context& io) : acceptor_(io)
+  {
+    tcp::endpoint ep(asio::ip::address_v4::loopback(), 0);
+    acceptor_.open(ep.protocol());
+    acceptor_.bind(ep);
+    acceptor_.listen(0);
+    // 异步发起几个连接把队列占满，不 accept 它们
+    for (int i = 0; i < 4; ++i)
+    {
+      fillers_.emplace_back(new tcp::socket(io));
+      fillers_.back()->async_connect(acceptor_.local_endpoint(), [](std::error_code) {});
+    }
+  }
+
+  tcp::endpoint endpoint() const
+  {
+    return acceptor_.local_endpoint();
+  }
+
+ private:
+  tcp::acceptor acceptor_;
+  std::vector<std::unique_ptr<tcp::socket>> fillers_;
+};
+
+// 接受连接后在客户端要求时断开，让客户端重连
+class Server
+{
+ public:
+  Server(asio::io_context& io, const asio::ip::address& address) : acceptor_(io, tcp::endpoint(address, 0))
+  {
+    start_accept();
+  }
+
+  tcp::endpoint endpoint() const
+  {
+    return acceptor_.local_endpoint();
+  }
+
+  void drop_all()
+  {
+    std::error_code ec;
+    for (auto& s : sessions_) s->close(ec);
+    sessions_.clear();
+  }
+
+ private:
+  void start_accept()
+  {
+    acceptor_.async_accept([this](std::error_code ec, tcp::socket socket) {
+      if (ec) return;
+      sessions_.push_back(std::make_shared<tcp::socket>(std::move(socket)));
+      start_accept();
+    });
+  }
+
+  tcp::acceptor acceptor_;
+  std::vector<std::shared_ptr<tcp::socket>> sessions_;
+};
+
+void run(const char* name, bool happy_eyeballs, int rounds, std::chrono::milliseconds deadline, asio::io_context& sio,
+         Server& server, const std::vector<tcp::endpoint>& endpoints)
+{
+  asio::io_context io;
+  auto cache = std::make_shared<DnsCache>(std::chrono::seconds(0));
+  cache->set_resolve_function(
+    [endpoints](asio::io_context&, const std::string& host, const std::string& port, DnsCache::Handler handler) {
+      handler(std::error_code(), DnsCache::Results::create(endpoints.begin(), endpoints.end(), host, port));
+    });
+
+  TcpClient::Options options;
+  options.happy_eyeballs = happy_eyeballs;
+  auto client = std::make_shared<TcpClient>(io, "dual-stack.test", "0", options);
+  client->set_dns_cache(cache);
+  TcpClient::ReconnectPolicy policy;
+  policy.base = std::chrono::milliseconds(10);
+  policy.max_delay = std::chrono::milliseconds(10);
+  policy.jitter = false;
+  client->set_reconnect_policy(policy);
+  client->start();
+  std::thread t([&io] {
+    auto work = asio::make_work_guard(io);
+    io.run();
+  });
+
+  std::cout << name << ":";
+  for (int i = 0; i < rounds; ++i)
+  {
+    Clock::time_point begin = Clock::now();
+    while (!client->is_connected() && Clock::now() - begin < deadline)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    if (!client->is_connected())
+    {
+      std::cout << " timeout(>" << deadline.count() << "ms)";
+      break;
+    }
+    std::cout << " " << std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - begin).count() << "ms";
+    // 服务器断开，客户端随后重连（服务器可能尚未处理 accept 完成，断开前重复投递）
+    while (client->is_connected())
+    {
+      asio::post(sio, [&server] { server.drop_all(); });
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  std::cout << "\n";
+
+  client->stop();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  io.stop();
+  t.join();
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  int rounds = argc > 1 ? std::atoi(argv[1]) : 3;
+  std::chrono::milliseconds deadline(argc > 2 ? std::atoi(argv[2]) : 3000);
+
+  asio::io_context sio;
+  BlackHole hole(sio);
+  std::unique_ptr<Server> server;
+  try
+  {
+    server.reset(new Server(sio, asio::ip::address_v6::loopback()));
+  }
+  catch (const std::exception&)
+  {
+    server.reset(new Server(sio, asio::ip::address_v4::loopback()));
+  }
+  auto work = asio::make_work_guard(sio);
+  std::thread st([&sio] { sio.run(); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  // 首地址黑洞，次地址可用
+  std::vector<tcp::endpoint> endpoints{hole.endpoint(), server->endpoint()};
+  std::cout << "endpoints: " << endpoints[0] << " (black hole), " << endpoints[1] << "\n";
+  run("sequential    ", false, rounds, deadline, sio, *server, endpoints);
+  run("happy eyeballs", true, rounds, deadline, sio, *server, endpoints);
+
+  work.reset();
+  sio.stop();
+  st.join();
+}
@@ -0,0 +1,169 @@
+/*
+  重连风暴模拟: N 个 TcpClient 连接到回环服务器，服务器"重启"（关闭所有连接和监听，停机一段时间后重新监听），
+  统计服务器重新监听后每 100ms 窗口内收到的连接数峰值、全部客户端恢复所需时间以及客户端的连接尝试总数。
+  对比三种模式:
+    lockstep        : 固定翻倍退避，无抖动，不限速（旧行为）
+    jitter          : 去相关抖动退避
+    jitter+limiter  : 去相关抖动 + io_context 共享的令牌桶连接限速
+  用法: reconnect_storm [clients] [limiter_rate_per_sec]
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "network/tcp_client.h"
+
+using asio::ip::tcp;
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+const std::chrono::milliseconds kDowntime(1500);  // 服务器停机时长
+const std::chrono::milliseconds kWindow(100);     // 统计窗口
+
+// 可重启的服务器，只接受连接并保持
+class RestartableServer
+{
+ public:
+  explicit RestartableServer(asio::io_context& io) : acceptor_(io) {}
+
+  void listen(unsigned short port)
+  {
+    tcp::endpoint ep(asio::ip::address_v4::loopback(), port);
+    acceptor_.open(ep.protocol());
+    acceptor_.set_option(tcp::acceptor::reuse_address(true));
+    acceptor_.bind(ep);
+    acceptor_.listen(asio::socket_base::max_listen_connections);
+    start_accept();
+  }
+
+  unsigned short port() const
+  {
+    return acceptor_.local_endpoint().port();
+  }
+
+  // 关闭监听和所有连接
+  void shutdown()
+  {
+    std::error_code ec;
+    acceptor_.close(ec);
+    for (auto& s : sessions_) s->close(ec);
+    sessions_.clear();
+  }
+
+  std::vector<Clock::time_point> accept_times;  // 每次 accept 的时间
+
+ private:
+  void start_accept()
+  {
+    acceptor_.async_accept([this](std::error_code ec, tcp::socket socket) {
+      if (ec) return;
+      accept_times.push_back(Clock::now());
+      sessions_.push_back(std::make_shared<tcp::socket>(std::move(socket)));
+      start_accept();
+    });
+  }
+
+  tcp::acceptor acceptor_;
+  std::vector<std::shared_ptr<tcp::socket>> sessions_;
+};
+
+void run(const char* name, int clients, bool jitter, double limiter_rate)
+{
+  asio::io_context server_io;
+  RestartableServer server(server_io);
+  server.listen(0);
+  unsigned short port = server.port();
+  auto server_work = asio::make_work_guard(server_io);
+  std::thread server_thread([&server_io] { server_io.run(); });
+
+  asio::io_context client_io;
+  if (limiter_rate > 0)
+    ConnectRateLimiter::get(client_io).configure(limiter_rate, static_cast<std::size_t>(limiter_rate / 10));
+
+  std::atomic<int> connected{0};
+  std::vector<std::shared_ptr<TcpClient>> pool;
+  TcpClient::ReconnectPolicy policy;
+  policy.base = std::chrono::milliseconds(500);
+  policy.max_delay = std::chrono::milliseconds(8000);
+  policy.jitter = jitter;
+  for (int i = 0; i < clients; ++i)
+  {
+    auto c = std::make_shared<TcpClient>(client_io, "127.0.0.1", std::to_string(port));
+    c->set_reconnect_policy(policy);
+    c->set_status_callback([&connected](TcpClient::Status s, const std::string&) {
+      if (s == TcpClient::Status::Connected) ++connected;
+    });
+    c->start();
+    pool.push_back(c);
+  }
+  std::thread client_thread([&client_io] { client_io.run(); });
+
+  // 等待全部连接后重启服务器
+  while (connected.load() < clients) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  std::uint64_t attempts_before = 0;
+  for (auto& c : pool) attempts_before += c->metrics().reconnects;
+  connected.store(0);
+  asio::post(server_io, [&server] { server.shutdown(); });
+  std::this_thread::sleep_for(kDowntime);
+
+  Clock::time_point reopened;
+  asio::post(server_io, [&server, &reopened, port] {
+    server.accept_times.clear();
+    reopened = Clock::now();
+    server.listen(port);
+  });
+
+  Clock::time_point deadline = Clock::now() + std::chrono::seconds(60);
+  while (connected.load() < clients && Clock::now() < deadline)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+  std::uint64_t attempts = 0;
+  for (auto& c : pool)
+  {
+    attempts += c->metrics().reconnects;
+    c->stop();
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  client_io.stop();
+  client_thread.join();
+
+  // 统计在 server io 线程中完成的 accept 时间
+  std::vector<Clock::time_point> times;
+  asio::post(server_io, [&] {
+    times = server.accept_times;
+    server.shutdown();
+    server_work.reset();
+  });
+  server_thread.join();
+
+  std::vector<int> windows;
+  for (auto t : times)
+  {
+    std::size_t w = static_cast<std::size_t>((t - reopened) / kWindow);
+    if (windows.size() <= w) windows.resize(w + 1);
+    ++windows[w];
+  }
+  int peak = windows.empty() ? 0 : *std::max_element(windows.begin(), windows.end());
+  double recovery = times.empty() ? 0 : std::chrono::duration<double>(times.back() - reopened).count();
+
+  std::cout << name << ": reconnected " << times.size() << "/" << clients << ", peak " << peak
+            << " accepts per 100ms, recovered in " << recovery << "s, connect attempts "
+            << attempts - attempts_before << "\n";
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  int clients = argc > 1 ? std::atoi(argv[1]) : 5000;
+  double rate = argc > 2 ? std::atof(argv[2]) : 2000;
+
+  run("lockstep      ", clients, false, 0);
+  run("jitter        ", clients, true, 0);
+  run("jitter+limiter", clients, true, rate);
+}
@@ -0,0 +1,255 @@
+/*
+  短连接会话分配对比（daytime 模式: 接受连接 - 写出时间字符串 - 关闭）
+    shared_ptr : 每个连接 new 一个会话并包在 shared_ptr 里，每个处理函数复制 shared_ptr（原子引用计数）
+    pool       : 会话来自 SessionPool 的 slab，SessionRef 非原子计数，引用归零后会话及其 socket 对象被回收复用
+  服务器运行在独立线程上，客户端线程循环 "阻塞连接 - 读到 EOF"，统计每秒完成的连接数，
+  并统计服务器线程上平均每个连接的堆分配次数
+  用法: session_pool [seconds=2] [client_threads=2]
+*/
+
+#include <asio.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "alloc_counter.h"
+#include "network/session_pool.h"
+
+using asio::ip::tcp;
+
+namespace
+{
+std::string make_daytime_string()
+{
+  std::time_t now = std::time(0);
+  return std::ctime(&now);
+}
+
+// 改动前: shared_ptr 会话
+class SharedConnection : public std::enable_shared_from_this<SharedConnection>
+{
+ public:
+  typedef std::shared_ptr<SharedConnection> pointer;
+
+  static pointer create(asio::io_context& io)
+  {
+    return pointer(new SharedConnection(io));
+  }
+
+  tcp::socket& socket()
+  {
+    return socket_;
+  }
+
+  void start()
+  {
+    message_ = make_daytime_string();
+    asio::async_write(socket_, asio::buffer(message_),
+                      std::bind(&SharedConnection::handle_write, shared_from_this(), asio::placeholders::error));
+  }
+
+ private:
+  explicit SharedConnection(asio::io_context& io) : socket_(io) {}
+
+  void handle_write(const std::error_code&) {}
+
+  tcp::socket socket_;
+  std::string message_;
+};
+
+class SharedServer
+{
+ public:
+  explicit SharedServer(asio::io_context& io) :
+    io_(io), acceptor_(io, tcp::endpoint(asio::ip::address_v4::loopback(), 0))
+  {
+    start_accept();
+  }
+
+  unsigned short port() const
+  {
+    return acceptor_.local_endpoint().port();
+  }
+
+  void close()
+  {
+    std::error_code ec;
+    acceptor_.close(ec);
+  }
+
+ private:
+  void start_accept()
+  {
+    SharedConnection::pointer conn = SharedConnection::create(io_);
+    acceptor_.async_accept(conn->socket(),
+                           std::bind(&SharedServer::handle_accept, this, conn, asio::placeholders::error));
+  }
+
+  void handle_accept(SharedConnection::pointer conn, const std::error_code& error)
+  {
+    if (error == asio::error::operation_aborted) return;
+    if (!error) conn->start();
+    start_accept();
+  }
+
+  asio::io_context& io_;
+  tcp::acceptor acceptor_;
+};
+
+// 改动后: 池化会话
+class PooledConnection : public PooledSession<PooledConnection>
+{
+ public:
+  typedef SessionRef<PooledConnection> pointer;
+
+  explicit PooledConnection(asio::io_context& io) : socket_(io) {}
+
+  tcp::socket& socket()
+  {
+    return socket_;
+  }
+
+  void start()
+  {
+    std::time_t now = std::time(0);
+    message_.assign(std::ctime(&now));
+    asio::async_write(socket_, asio::buffer(message_),
+                      std::bind(&PooledConnection::handle_write, self(), asio::placeholders::error));
+  }
+
+  void reset()
+  {
+    std::error_code ec;
+    socket_.close(ec);
+  }
+
+ private:
+  void handle_write(const std::error_code&) {}
+
+  tcp::socket socket_;
+  std::string message_;
+};
+
+class PooledServer
+{
+ public:
+  explicit PooledServer(asio::io_context& io) :
+    pool_(64, [&io](void* p) { return new (p) PooledConnection(io); }),
+    acceptor_(io, tcp::endpoint(asio::ip::address_v4::loopback(), 0))
+  {
+    start_accept();
+  }
+
+  unsigned short port() const
+  {
+    return acceptor_.local_endpoint().port();
+  }
+
+  void close()
+  {
+    std::error_code ec;
+    acceptor_.close(ec);
+  }
+
+ private:
+  void start_accept()
+  {
+    PooledConnection::pointer conn = pool_.acquire();
+    acceptor_.async_accept(conn->socket(),
+                           std::bind(&PooledServer::handle_accept, this, conn, asio::placeholders::error));
+  }
+
+  void handle_accept(PooledConnection::pointer conn, const std::error_code& error)
+  {
+    if (error == asio::error::operation_aborted) return;
+    if (!error) conn->start();
+    start_accept();
+  }
+
+  SessionPool<PooledConnection> pool_;
+  tcp::acceptor acceptor_;
+};
+
+struct Result
+{
+  double connects_per_sec = 0;
+  double allocations_per_connect = 0;
+};
+
+// 服务器在独立线程上运行；结束时关闭接受器，让 io_context 自然跑完（会话引用在池析构前全部释放）
+template <typename Server>
+Result run(std::chrono::seconds duration, int client_threads)
+{
+  asio::io_context io(1);
+  Server server(io);
+  std::thread server_thread([&io] {
+    alloc_counter::count_this_thread();  // 只统计服务器线程上的堆分配
+    io.run();
+  });
+
+  std::atomic<bool> running{true};
+  std::atomic<std::uint64_t> done{0};
+  tcp::endpoint endpoint(asio::ip::address_v4::loopback(), server.port());
+  std::vector<std::thread> clients;
+  // 预热一小段时间，之后开始计数
+  std::atomic<bool> counting{false};
+  for (int i = 0; i < client_threads; ++i)
+  {
+    clients.emplace_back([&] {
+      asio::io_context cio;
+      char buf[64];
+      while (running.load(std::memory_order_relaxed))
+      {
+        tcp::socket socket(cio);
+        std::error_code ec;
+        socket.connect(endpoint, ec);
+        if (ec) continue;
+        while (!ec) socket.read_some(asio::buffer(buf), ec);
+        if (ec == asio::error::eof && counting.load(std::memory_order_relaxed))
+          done.fetch_add(1, std::memory_order_relaxed);
+      }
+    });
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  std::size_t alloc_start = alloc_counter::allocations();
+  std::uint64_t done_start = done.load();
+  counting.store(true);
+  std::this_thread::sleep_for(duration);
+  counting.store(false);
+  std::size_t allocations = alloc_counter::allocations() - alloc_start;
+  std::uint64_t connects = done.load() - done_start;
+  running.store(false);
+  for (auto& t : clients) t.join();
+
+  asio::post(io, [&server] { server.close(); });
+  server_thread.join();
+
+  Result r;
+  r.connects_per_sec = static_cast<double>(connects) / duration.count();
+  r.allocations_per_connect = connects ? static_cast<double>(allocations) / connects : 0;
+  return r;
+}
+
+void report(const char* name, const Result& r)
+{
+  std::cout << name << ": connects/s=" << static_cast<std::uint64_t>(r.connects_per_sec)
+            << " server allocations/connect=" << r.allocations_per_connect << "\n";
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  std::chrono::seconds duration(argc > 1 ? std::atoi(argv[1]) : 2);
+  int client_threads = argc > 2 ? std::atoi(argv[2]) : 2;
+
+  report("shared_ptr", run<SharedServer>(duration, client_threads));
+  report("pool      ", run<PooledServer>(duration, client_threads));
+}
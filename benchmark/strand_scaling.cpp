@@ -0,0 +1,173 @@
+/*
+  strand 扩展性基准: 多个启用 use_strand 的 TcpClient 共享一个 io_context，分别用 1/2/4/8 个线程运行该 io_context，
+  每个客户端循环发送固定大小的帧，回环服务器只读不回，统计服务器每秒收到的消息数。
+  服务器运行在独立的多线程 io_context 上，每个连接一个 strand，避免服务器成为瓶颈。
+  用法: strand_scaling [clients] [seconds_per_run] [message_size]
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "network/tcp_client.h"
+
+using asio::ip::tcp;
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+const std::size_t kInFlight = 64;  // 每个客户端保持的在途消息数
+
+// 只读不回的服务器，按帧长统计收到的消息数
+class SinkServer
+{
+ public:
+  SinkServer(asio::io_context& io, std::size_t message_size) :
+    io_(io), acceptor_(io, tcp::endpoint(asio::ip::address_v4::loopback(), 0)), message_size_(message_size)
+  {
+    start_accept();
+  }
+
+  unsigned short port() const
+  {
+    return acceptor_.local_endpoint().port();
+  }
+
+  std::uint64_t received() const
+  {
+    return bytes_.load() / message_size_;
+  }
+
+  void close()
+  {
+    std::error_code ec;
+    acceptor_.close(ec);
+  }
+
+ private:
+  struct Session : std::enable_shared_from_this<Session>
+  {
+    Session(tcp::socket s, std::atomic<std::uint64_t>& counter) : socket(std::move(s)), bytes(counter) {}
+
+    void read()
+    {
+      auto self = shared_from_this();
+      socket.async_read_some(asio::buffer(buf), [self](std::error_code ec, std::size_t n) {
+        if (ec) return;
+        self->bytes += n;
+        self->read();
+      });
+    }
+
+    tcp::socket socket;
+    std::atomic<std::uint64_t>& bytes;
+    char buf[64 * 1024];
+  };
+
+  void start_accept()
+  {
+    acceptor_.async_accept(asio::make_strand(io_), [this](std::error_code ec, tcp::socket socket) {
+      if (ec) return;
+      std::make_shared<Session>(std::move(socket), bytes_)->read();
+      start_accept();
+    });
+  }
+
+  asio::io_context& io_;
+  tcp::acceptor acceptor_;
+  std::size_t message_size_;
+  std::atomic<std::uint64_t> bytes_{0};
+};
+
+// 发送完成一批后补足在途消息，使每个客户端始终有 kInFlight 条消息排队
+void refill(const std::shared_ptr<TcpClient>& client, const std::string& message)
+{
+  while (client->queued_messages() < kInFlight)
+  {
+    if (!client->send(message)) break;
+  }
+}
+
+double run(unsigned short port, int clients, int threads, double seconds, std::size_t message_size,
+           const SinkServer& server)
+{
+  asio::io_context io;
+  std::string message(message_size, 'x');
+  TcpClient::Options options;
+  options.use_strand = true;
+  options.no_delay = true;
+
+  std::atomic<int> connected{0};
+  std::vector<std::shared_ptr<TcpClient>> pool;
+  for (int i = 0; i < clients; ++i)
+  {
+    auto c = std::make_shared<TcpClient>(io, "127.0.0.1", std::to_string(port), options);
+    std::weak_ptr<TcpClient> weak = c;
+    c->set_status_callback([&connected, weak, &message](TcpClient::Status s, const std::string&) {
+      if (s != TcpClient::Status::Connected) return;
+      ++connected;
+      if (auto self = weak.lock()) refill(self, message);
+    });
+    c->set_flush_callback([weak, &message](std::size_t, std::size_t) {
+      if (auto self = weak.lock()) refill(self, message);
+    });
+    c->start();
+    pool.push_back(c);
+  }
+
+  std::vector<std::thread> runners;
+  for (int i = 0; i < threads; ++i) runners.emplace_back([&io] { io.run(); });
+
+  while (connected.load() < clients) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  // 预热后开始计时
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  std::uint64_t begin_count = server.received();
+  Clock::time_point begin = Clock::now();
+  std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+  std::uint64_t end_count = server.received();
+  double elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+
+  for (auto& c : pool) c->stop();
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  io.stop();
+  for (auto& t : runners) t.join();
+  return (end_count - begin_count) / elapsed;
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  int clients = argc > 1 ? std::atoi(argv[1]) : 64;
+  double seconds = argc > 2 ? std::atof(argv[2]) : 2.0;
+  std::size_t message_size = argc > 3 ? static_cast<std::size_t>(std::atoi(argv[3])) : 128;
+
+  asio::io_context server_io;
+  SinkServer server(server_io, message_size);
+  auto work = asio::make_work_guard(server_io);
+  std::vector<std::thread> server_threads;
+  for (unsigned i = 0; i < std::max(2u, std::thread::hardware_concurrency() / 2); ++i)
+    server_threads.emplace_back([&server_io] { server_io.run(); });
+
+  std::cout << clients << " clients, " << message_size << "-byte messages, " << std::thread::hardware_concurrency()
+            << " hardware threads\n";
+  double baseline = 0;
+  for (int threads : {1, 2, 4, 8})
+  {
+    double rate = run(server.port(), clients, threads, seconds, message_size, server);
+    if (threads == 1) baseline = rate;
+    std::cout << threads << " thread(s): " << static_cast<std::uint64_t>(rate) << " msgs/s";
+    if (baseline > 0) std::cout << " (x" << rate / baseline << ")";
+    std::cout << "\n";
+  }
+
+  asio::post(server_io, [&server, &work] {
+    server.close();
+    work.reset();
+  });
+  server_io.stop();
+  for (auto& t : server_threads) t.join();
+}
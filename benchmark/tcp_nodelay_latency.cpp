@@ -0,0 +1,149 @@
+/*
+  回环地址上的 TCP_NODELAY 延迟对比
+  客户端把一个请求拆成 "头部 + 正文" 两次写出（第二次写在第一次写完成后才发起），
+  服务端收齐完整请求后才回复。开启 Nagle 时第二次小写会等待第一次的 ACK，
+  与对端的延迟 ACK 叠加后每个请求会多出数十毫秒；关闭 Nagle 后请求立即发出。
+  用法: tcp_nodelay_latency [iterations]
+*/
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "network/tcp_client.h"
+
+using asio::ip::tcp;
+
+namespace
+{
+const std::size_t kHeaderSize = 16;
+const std::size_t kBodySize = 48;
+const std::size_t kRequestSize = kHeaderSize + kBodySize;
+
+// 回显服务器: 每收齐 kRequestSize 字节回复同样大小的数据
+class RequestServer
+{
+ public:
+  explicit RequestServer(asio::io_context& io) : acceptor_(io, tcp::endpoint(asio::ip::address_v4::loopback(), 0))
+  {
+    start_accept();
+  }
+
+  unsigned short port() const
+  {
+    return acceptor_.local_endpoint().port();
+  }
+
+ private:
+  struct Session : std::enable_shared_from_this<Session>
+  {
+    explicit Session(tcp::socket s) : socket(std::move(s)) {}
+
+    void start()
+    {
+      auto self = shared_from_this();
+      asio::async_read(socket, asio::buffer(buf), [self](std::error_code ec, std::size_t) {
+        if (ec) return;
+        asio::async_write(self->socket, asio::buffer(self->buf), [self](std::error_code ec, std::size_t) {
+          if (!ec) self->start();
+        });
+      });
+    }
+
+    tcp::socket socket;
+    std::array<char, kRequestSize> buf;
+  };
+
+  void start_accept()
+  {
+    acceptor_.async_accept([this](std::error_code ec, tcp::socket socket) {
+      if (!ec) std::make_shared<Session>(std::move(socket))->start();
+      start_accept();
+    });
+  }
+
+  tcp::acceptor acceptor_;
+};
+
+// 测量一轮请求的往返延迟（微秒）
+std::vector<double> run(unsigned short port, bool no_delay, int iterations)
+{
+  asio::io_context io;
+  TcpClient::Options options;
+  options.no_delay = no_delay;
+  auto client = std::make_shared<TcpClient>(io, "127.0.0.1", std::to_string(port), options);
+  client->set_frame_codec(std::make_shared<FixedSizeCodec>(kRequestSize));
+
+  std::vector<double> samples;
+  std::chrono::steady_clock::time_point sent_at;
+  bool header_pending = false;
+  const std::string header(kHeaderSize, 'h');
+  const std::string body(kBodySize, 'b');
+
+  auto send_request = [&] {
+    sent_at = std::chrono::steady_clock::now();
+    header_pending = true;
+    client->send(header);
+  };
+
+  // 头部写完后再发正文，确保两次写不会被合并
+  client->set_flush_callback([&](std::size_t, std::size_t) {
+    if (header_pending)
+    {
+      header_pending = false;
+      client->send(body);
+    }
+  });
+  client->set_message_view_callback([&](asio::const_buffer) {
+    auto elapsed = std::chrono::steady_clock::now() - sent_at;
+    samples.push_back(std::chrono::duration<double, std::micro>(elapsed).count());
+    if (static_cast<int>(samples.size()) == iterations)
+    {
+      client->stop();
+      io.stop();
+      return;
+    }
+    send_request();
+  });
+  client->set_status_callback([&](TcpClient::Status s, const std::string&) {
+    if (s == TcpClient::Status::Connected) send_request();
+  });
+
+  client->start();
+  io.run();
+  return samples;
+}
+
+void report(const char* name, std::vector<double> samples)
+{
+  if (samples.empty()) return;
+  std::sort(samples.begin(), samples.end());
+  double sum = 0;
+  for (double v : samples) sum += v;
+  std::cout << name << ": n=" << samples.size() << " mean=" << sum / samples.size() << "us"
+            << " p50=" << samples[samples.size() / 2] << "us"
+            << " p99=" << samples[std::min(samples.size() - 1, samples.size() * 99 / 100)] << "us"
+            << " max=" << samples.back() << "us\n";
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  int iterations = argc > 1 ? std::atoi(argv[1]) : 50;
+
+  asio::io_context server_io;
+  RequestServer server(server_io);
+  std::thread server_thread([&server_io] { server_io.run(); });
+
+  report("nagle on  (no_delay=false)", run(server.port(), false, iterations));
+  report("nagle off (no_delay=true) ", run(server.port(), true, iterations));
+
+  server_io.stop();
+  server_thread.join();
+}
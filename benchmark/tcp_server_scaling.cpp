@@ -0,0 +1,179 @@
+/*
+  TcpServer 按工作线程数的扩展性基准
+  - 建连速率: 服务器接受连接后立即关闭（daytime 式短连接），
+    客户端线程循环 "阻塞连接 - 读到 EOF - 关闭"，统计每秒完成的连接数
+  - 回显吞吐: 每个客户端线程一个 io_context，上面若干长连接循环 "写 size 字节 - 读回 size 字节"，统计每秒回显的字节数
+  工作线程数从 1 开始翻倍到 max_workers；服务器每个工作线程一个 SO_REUSEPORT 接受器，
+  客户端与服务器在同一台机器上，总核数不足时客户端本身会成为瓶颈
+  用法: tcp_server_scaling [max_workers=4] [seconds=2] [client_threads=4] [conns_per_thread=8] [size=16384]
+*/
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "network/tcp_server.h"
+
+using asio::ip::tcp;
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+// 短连接: 客户端线程循环建连，服务器立即关闭
+double connect_rate(unsigned short port, int client_threads, std::chrono::seconds duration)
+{
+  std::atomic<bool> running{true};
+  std::atomic<std::uint64_t> done{0};
+  std::vector<std::thread> threads;
+  tcp::endpoint endpoint(asio::ip::address_v4::loopback(), port);
+  for (int i = 0; i < client_threads; ++i)
+  {
+    threads.emplace_back([&] {
+      asio::io_context io;
+      char buf[64];
+      while (running.load(std::memory_order_relaxed))
+      {
+        tcp::socket socket(io);
+        std::error_code ec;
+        socket.connect(endpoint, ec);
+        if (ec) continue;
+        while (!ec) socket.read_some(asio::buffer(buf), ec);
+        if (ec == asio::error::eof) done.fetch_add(1, std::memory_order_relaxed);
+      }
+    });
+  }
+  std::this_thread::sleep_for(duration);
+  running.store(false);
+  for (auto& t : threads) t.join();
+  return static_cast<double>(done.load()) / duration.count();
+}
+
+// 长连接回显: 写 size 字节后读回 size 字节，循环往复
+class EchoConnection : public std::enable_shared_from_this<EchoConnection>
+{
+ public:
+  EchoConnection(asio::io_context& io, std::size_t size, std::atomic<std::uint64_t>& bytes,
+                 const std::atomic<bool>& running) :
+    socket_(io), out_(size, 'e'), in_(size), bytes_(bytes), running_(running)
+  {
+  }
+
+  void start(const tcp::endpoint& endpoint)
+  {
+    auto self = shared_from_this();
+    socket_.async_connect(endpoint, [this, self](std::error_code ec) {
+      if (ec) return;
+      socket_.set_option(tcp::no_delay(true), ec);
+      do_round();
+    });
+  }
+
+ private:
+  void do_round()
+  {
+    if (!running_.load(std::memory_order_relaxed))
+    {
+      std::error_code ec;
+      socket_.close(ec);
+      return;
+    }
+    auto self = shared_from_this();
+    asio::async_write(socket_, asio::buffer(out_), [this, self](std::error_code ec, std::size_t) {
+      if (ec) return;
+      asio::async_read(socket_, asio::buffer(in_), [this, self](std::error_code ec, std::size_t n) {
+        if (ec) return;
+        bytes_.fetch_add(n, std::memory_order_relaxed);
+        do_round();
+      });
+    });
+  }
+
+  tcp::socket socket_;
+  std::string out_;
+  std::vector<char> in_;
+  std::atomic<std::uint64_t>& bytes_;
+  const std::atomic<bool>& running_;
+};
+
+double echo_throughput(unsigned short port, int client_threads, int conns_per_thread, std::size_t size,
+                       std::chrono::seconds duration)
+{
+  std::atomic<bool> running{true};
+  std::atomic<std::uint64_t> bytes{0};
+  std::vector<std::unique_ptr<asio::io_context>> contexts;
+  std::vector<std::thread> threads;
+  tcp::endpoint endpoint(asio::ip::address_v4::loopback(), port);
+  for (int i = 0; i < client_threads; ++i)
+  {
+    contexts.emplace_back(new asio::io_context(1));
+    for (int c = 0; c < conns_per_thread; ++c)
+      std::make_shared<EchoConnection>(*contexts.back(), size, bytes, running)->start(endpoint);
+  }
+  for (auto& io : contexts)
+  {
+    asio::io_context* ctx = io.get();
+    threads.emplace_back([ctx] { ctx->run(); });
+  }
+  // 预热后再计数
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  std::uint64_t start = bytes.load();
+  std::this_thread::sleep_for(duration);
+  std::uint64_t total = bytes.load() - start;
+  running.store(false);
+  for (auto& t : threads) t.join();
+  return static_cast<double>(total) / duration.count();
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  std::size_t max_workers = argc > 1 ? static_cast<std::size_t>(std::atoi(argv[1])) : 4;
+  std::chrono::seconds duration(argc > 2 ? std::atoi(argv[2]) : 2);
+  int client_threads = argc > 3 ? std::atoi(argv[3]) : 4;
+  int conns_per_thread = argc > 4 ? std::atoi(argv[4]) : 8;
+  std::size_t size = argc > 5 ? static_cast<std::size_t>(std::atoi(argv[5])) : 16384;
+
+  std::cout << "hardware threads=" << std::thread::hardware_concurrency() << " client threads=" << client_threads
+            << " echo conns=" << client_threads * conns_per_thread << " size=" << size << "\n";
+  for (std::size_t workers = 1; workers <= max_workers; workers *= 2)
+  {
+    TcpServer::Options options;
+    options.address = "127.0.0.1";
+    options.workers = workers;
+    std::error_code ec;
+
+    double conns = 0;
+    {
+      TcpServer server(options);
+      server.set_connection_callback([](const TcpServer::SessionPtr& session) { session->close(); });
+      if (!server.start(ec))
+      {
+        std::cerr << "start failed: " << ec.message() << "\n";
+        return 1;
+      }
+      conns = connect_rate(server.port(), client_threads, duration);
+    }
+
+    double throughput = 0;
+    {
+      TcpServer server(options);
+      server.set_message_callback([](const TcpServer::SessionPtr& session, asio::const_buffer data) {
+        session->send(std::string(static_cast<const char*>(data.data()), data.size()));
+      });
+      if (!server.start(ec))
+      {
+        std::cerr << "start failed: " << ec.message() << "\n";
+        return 1;
+      }
+      throughput = echo_throughput(server.port(), client_threads, conns_per_thread, size, duration);
+    }
+
+    std::cout << "workers=" << workers << " reuse_port=" << (options.reuse_port && workers > 1 ? "yes" : "no")
+              << " connects/s=" << static_cast<std::uint64_t>(conns)
+              << " echo MB/s=" << throughput / (1024 * 1024) << "\n";
+  }
+}
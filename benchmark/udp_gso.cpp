@@ -0,0 +1,301 @@
+/*
+  批量 UDP 发送的吞吐对比（同机回环，一个发送线程、一个接收线程）
+    plain   : 发送端逐个 async_send_to segment 字节的数据报，接收端逐个 async_receive_from
+    gso     : 发送端 UdpBatchSocket::send_segments 一次交给内核 segments 个数据报（UDP_SEGMENT），接收端 recvmmsg
+    gso+gro : 在 gso 的基础上接收端开启 UDP_GRO，内核把连续数据报合并成超级数据报交上来
+  发送端尽力发送，接收缓冲区满时内核丢包；统计每秒发出和收到的负载字节数，以及两端每 MiB 的系统调用次数（plain 不统计）
+  用法: udp_gso [seconds=2] [segment=1400] [segments=44]
+*/
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "network/udp_batch_socket.h"
+
+using asio::ip::udp;
+
+namespace
+{
+const int kReceiveBuffer = 4 * 1024 * 1024;  // 接收端 SO_RCVBUF
+
+struct Config
+{
+  std::chrono::seconds duration{2};
+  std::size_t segment = 1400;
+  std::size_t segments = 44;
+};
+
+// 两个线程共享的计数
+struct Counters
+{
+  std::atomic<bool> running{true};
+  std::atomic<bool> counting{false};
+  std::atomic<std::uint64_t> sent_bytes{0};      // 计数阶段发出的字节数
+  std::atomic<std::uint64_t> received_bytes{0};  // 计数阶段收到的字节数
+  std::atomic<std::uint64_t> total_sent{0};      // 包括预热阶段，用于计算每 MiB 的系统调用次数
+  std::atomic<std::uint64_t> total_received{0};
+  std::atomic<std::uint64_t> send_calls{0};
+  std::atomic<std::uint64_t> receive_calls{0};
+
+  void add_sent(std::uint64_t n)
+  {
+    add(sent_bytes, total_sent, n);
+  }
+
+  void add_received(std::uint64_t n)
+  {
+    add(received_bytes, total_received, n);
+  }
+
+ private:
+  // 累加总字节数，计数阶段同时累加窗口字节数
+  void add(std::atomic<std::uint64_t>& window, std::atomic<std::uint64_t>& total, std::uint64_t n)
+  {
+    total.fetch_add(n, std::memory_order_relaxed);
+    if (counting.load(std::memory_order_relaxed)) window.fetch_add(n, std::memory_order_relaxed);
+  }
+};
+
+udp::endpoint loopback(unsigned short port = 0)
+{
+  return udp::endpoint(asio::ip::address_v4::loopback(), port);
+}
+
+// 逐个接收
+class PlainReceiver
+{
+ public:
+  PlainReceiver(asio::io_context& io, Counters& counters, bool /*gro*/) : socket_(io, loopback()), counters_(counters)
+  {
+    socket_.set_option(asio::socket_base::receive_buffer_size(kReceiveBuffer));
+    start_receive();
+  }
+
+  unsigned short port() const
+  {
+    return socket_.local_endpoint().port();
+  }
+
+  void stop()
+  {
+    std::error_code ec;
+    socket_.close(ec);
+  }
+
+ private:
+  void start_receive()
+  {
+    socket_.async_receive_from(asio::buffer(buf_), remote_, [this](std::error_code ec, std::size_t n) {
+      if (ec == asio::error::operation_aborted || !socket_.is_open()) return;
+      if (!ec) counters_.add_received(n);
+      start_receive();
+    });
+  }
+
+  udp::socket socket_;
+  udp::endpoint remote_;
+  std::array<char, 65536> buf_;
+  Counters& counters_;
+};
+
+// recvmmsg 批量接收，可选 GRO
+class BatchReceiver
+{
+ public:
+  BatchReceiver(asio::io_context& io, Counters& counters, bool gro) :
+    socket_(io, loopback(), make_options(gro)), counters_(counters)
+  {
+    socket_.socket().set_option(asio::socket_base::receive_buffer_size(kReceiveBuffer));
+    if (gro && !socket_.gro()) std::cerr << "UDP_GRO not supported, receiving plain datagrams\n";
+    socket_.start([this](const UdpBatchSocket::Datagram* datagrams, std::size_t count) {
+      std::uint64_t bytes = 0;
+      for (std::size_t i = 0; i < count; ++i) bytes += datagrams[i].data.size();
+      counters_.add_received(bytes);
+    });
+  }
+
+  unsigned short port()
+  {
+    return socket_.socket().local_endpoint().port();
+  }
+
+  void stop()
+  {
+    counters_.receive_calls.store(socket_.stats().receive_calls);
+    socket_.stop();
+  }
+
+ private:
+  static UdpBatchSocket::Options make_options(bool gro)
+  {
+    UdpBatchSocket::Options options;
+    options.batch_size = gro ? 8 : 64;  // 合并后每条消息最大 64KB，少量槽位即可
+    options.max_datagram_size = gro ? 65535 : 2048;
+    options.gro = gro;
+    return options;
+  }
+
+  UdpBatchSocket socket_;
+  Counters& counters_;
+};
+
+// 逐个 async_send_to，上一个完成后发下一个
+class PlainSender
+{
+ public:
+  PlainSender(asio::io_context& io, const Config& cfg, Counters& counters, unsigned short port) :
+    socket_(io, loopback()), target_(loopback(port)), payload_(cfg.segment, 'g'), counters_(counters)
+  {
+    send();
+  }
+
+ private:
+  void send()
+  {
+    if (!counters_.running.load(std::memory_order_relaxed))
+    {
+      std::error_code ec;
+      socket_.close(ec);
+      return;
+    }
+    socket_.async_send_to(asio::buffer(payload_), target_, [this](std::error_code ec, std::size_t n) {
+      if (ec == asio::error::operation_aborted) return;
+      if (!ec) counters_.add_sent(n);
+      send();
+    });
+  }
+
+  udp::socket socket_;
+  udp::endpoint target_;
+  std::string payload_;
+  Counters& counters_;
+};
+
+// send_segments 一次发出 segments 个数据报，内核发送缓冲区满时等待可写
+class GsoSender
+{
+ public:
+  GsoSender(asio::io_context& io, const Config& cfg, Counters& counters, unsigned short port) :
+    io_(io),
+    socket_(io, loopback(), make_options(cfg)),
+    target_(loopback(port)),
+    payload_(cfg.segment * cfg.segments, 'g'),
+    segment_(cfg.segment),
+    counters_(counters)
+  {
+    if (!socket_.gso()) std::cerr << "UDP_SEGMENT not supported, sending plain datagrams\n";
+    pump();
+  }
+
+ private:
+  static UdpBatchSocket::Options make_options(const Config& cfg)
+  {
+    UdpBatchSocket::Options options;
+    options.batch_size = cfg.segments;  // 不支持 GSO 时每段占一个槽
+    options.max_datagram_size = 65535;
+    return options;
+  }
+
+  void pump()
+  {
+    if (!counters_.running.load(std::memory_order_relaxed))
+    {
+      counters_.send_calls.store(socket_.stats().send_calls);
+      socket_.stop();
+      return;
+    }
+    if (socket_.pending() == 0 && socket_.send_segments(asio::buffer(payload_), segment_, target_))
+    {
+      socket_.flush();
+      counters_.add_sent(payload_.size());
+    }
+    if (socket_.pending() == 0)
+    {
+      asio::post(io_, [this] { pump(); });
+      return;
+    }
+    // 内核发送缓冲区满: UdpBatchSocket 自己的可写等待先完成并发出剩余数据，之后再继续
+    socket_.socket().async_wait(udp::socket::wait_write, [this](std::error_code ec) {
+      if (!ec) pump();
+    });
+  }
+
+  asio::io_context& io_;
+  UdpBatchSocket socket_;
+  udp::endpoint target_;
+  std::string payload_;
+  std::size_t segment_;
+  Counters& counters_;
+};
+
+struct Result
+{
+  double sent_mib = 0;      // 每秒发出的 MiB
+  double received_mib = 0;  // 每秒收到的 MiB
+  double send_calls_per_mib = 0;
+  double receive_calls_per_mib = 0;
+};
+
+template <typename Receiver, typename Sender>
+Result run(const Config& cfg, bool gro)
+{
+  Counters counters;
+  asio::io_context rio(1), sio(1);
+  Receiver receiver(rio, counters, gro);
+  Sender sender(sio, cfg, counters, receiver.port());
+  std::thread rthread([&rio] { rio.run(); });
+  std::thread sthread([&sio] { sio.run(); });
+
+  // 预热后开始计数
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  counters.counting.store(true);
+  std::this_thread::sleep_for(cfg.duration);
+  counters.counting.store(false);
+  counters.running.store(false);
+  sthread.join();
+  asio::post(rio, [&receiver] { receiver.stop(); });
+  rthread.join();
+
+  const double mib = 1024.0 * 1024.0;
+  const double seconds = static_cast<double>(cfg.duration.count());
+  Result r;
+  r.sent_mib = counters.sent_bytes.load() / mib / seconds;
+  r.received_mib = counters.received_bytes.load() / mib / seconds;
+  // 系统调用次数覆盖整个运行过程（包括预热），按同一时段的总字节数折算
+  if (counters.total_sent.load())
+    r.send_calls_per_mib = counters.send_calls.load() / (counters.total_sent.load() / mib);
+  if (counters.total_received.load())
+    r.receive_calls_per_mib = counters.receive_calls.load() / (counters.total_received.load() / mib);
+  return r;
+}
+
+void report(const char* name, const Result& r, bool calls)
+{
+  std::cout << std::fixed << std::setprecision(1) << name << ": sent MiB/s=" << r.sent_mib
+            << " received MiB/s=" << r.received_mib;
+  if (calls)
+    std::cout << " send calls/MiB=" << r.send_calls_per_mib << " receive calls/MiB=" << r.receive_calls_per_mib;
+  std::cout << "\n";
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  Config cfg;
+  if (argc > 1) cfg.duration = std::chrono::seconds(std::atoi(argv[1]));
+  if (argc > 2) cfg.segment = static_cast<std::size_t>(std::atoi(argv[2]));
+  if (argc > 3) cfg.segments = static_cast<std::size_t>(std::atoi(argv[3]));
+
+  std::cout << "segment=" << cfg.segment << " segments per send=" << cfg.segments << "\n";
+  report("plain  ", run<PlainReceiver, PlainSender>(cfg, false), false);
+  report("gso    ", run<BatchReceiver, GsoSender>(cfg, false), true);
+  report("gso+gro", run<BatchReceiver, GsoSender>(cfg, true), true);
+}
@@ -0,0 +1,255 @@
+/*
+  UDP 请求-应答服务器的逐个收发与批量收发对比
+    plain : 每个数据报一次 async_receive_from、一次 async_send_to（udp_server_async 的默认模式）
+    batch : UdpBatchSocket，一次 recvmmsg 收一批请求，回复在回调返回后用一次 sendmmsg 发出
+  服务器运行在独立线程上，原样回显 size 字节的请求；客户端线程各用一个 UdpBatchSocket 保持 window 个请求在途，
+  收到回复立即补发，一段时间没有回复时（丢包）重新补满窗口。统计服务器每秒回复的数据报数，
+  批量模式下同时给出服务器平均每个数据报的系统调用次数
+  用法: udp_mmsg [seconds=2] [client_threads=2] [window=128] [batch=64] [size=32]
+*/
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "network/udp_batch_socket.h"
+
+using asio::ip::udp;
+
+namespace
+{
+struct Config
+{
+  std::chrono::seconds duration{2};
+  int client_threads = 2;
+  std::size_t window = 128;
+  std::size_t batch = 64;
+  std::size_t size = 32;
+};
+
+// 逐个收发的回显服务器
+class PlainServer
+{
+ public:
+  PlainServer(asio::io_context& io, const Config&) : socket_(io, udp::endpoint(asio::ip::address_v4::loopback(), 0))
+  {
+    start_receive();
+  }
+
+  unsigned short port() const
+  {
+    return socket_.local_endpoint().port();
+  }
+
+  void close()
+  {
+    std::error_code ec;
+    socket_.close(ec);
+  }
+
+  std::uint64_t syscalls() const
+  {
+    return 0;  // 由 asio 内部发起，无法统计
+  }
+
+ private:
+  void start_receive()
+  {
+    socket_.async_receive_from(asio::buffer(recv_buf_), remote_, [this](std::error_code ec, std::size_t n) {
+      if (ec == asio::error::operation_aborted || !socket_.is_open()) return;
+      if (!ec)
+      {
+        // 回复内容拷贝到独立缓冲区，发送期间可以继续接收
+        std::shared_ptr<std::string> reply(new std::string(recv_buf_.data(), n));
+        socket_.async_send_to(asio::buffer(*reply), remote_, [reply](std::error_code, std::size_t) {});
+      }
+      start_receive();
+    });
+  }
+
+  udp::socket socket_;
+  udp::endpoint remote_;
+  std::array<char, 2048> recv_buf_;
+};
+
+// 批量收发的回显服务器
+class BatchServer
+{
+ public:
+  BatchServer(asio::io_context& io, const Config& cfg) :
+    socket_(io, udp::endpoint(asio::ip::address_v4::loopback(), 0), make_options(cfg.batch))
+  {
+    socket_.start([this](const UdpBatchSocket::Datagram* datagrams, std::size_t count) {
+      for (std::size_t i = 0; i < count; ++i) socket_.send_to(datagrams[i].data, datagrams[i].remote);
+    });
+  }
+
+  unsigned short port()
+  {
+    return socket_.socket().local_endpoint().port();
+  }
+
+  void close()
+  {
+    socket_.stop();
+  }
+
+  std::uint64_t syscalls() const
+  {
+    return socket_.stats().receive_calls + socket_.stats().send_calls;
+  }
+
+ private:
+  static UdpBatchSocket::Options make_options(std::size_t batch)
+  {
+    UdpBatchSocket::Options options;
+    options.batch_size = batch;
+    return options;
+  }
+
+  UdpBatchSocket socket_;
+};
+
+// 客户端线程: 保持 window 个请求在途
+class Client
+{
+ public:
+  Client(const Config& cfg, unsigned short port, const std::atomic<bool>& counting, std::atomic<std::uint64_t>& done) :
+    cfg_(cfg),
+    socket_(io_, udp::endpoint(asio::ip::address_v4::loopback(), 0), make_options(cfg.window)),
+    server_(asio::ip::address_v4::loopback(), port),
+    request_(cfg.size, 'u'),
+    timer_(io_),
+    counting_(counting),
+    done_(done)
+  {
+  }
+
+  void run(const std::atomic<bool>& running)
+  {
+    socket_.start([this](const UdpBatchSocket::Datagram*, std::size_t count) {
+      replies_ += count;
+      if (counting_.load(std::memory_order_relaxed)) done_.fetch_add(count, std::memory_order_relaxed);
+      for (std::size_t i = 0; i < count; ++i) socket_.send_to(asio::buffer(request_), server_);
+    });
+    fill_window();
+    tick(running);
+    io_.run();
+  }
+
+ private:
+  static UdpBatchSocket::Options make_options(std::size_t window)
+  {
+    UdpBatchSocket::Options options;
+    options.batch_size = window;
+    return options;
+  }
+
+  void fill_window()
+  {
+    for (std::size_t i = 0; i < cfg_.window; ++i) socket_.send_to(asio::buffer(request_), server_);
+    socket_.flush();
+  }
+
+  // 定期检查: 一个周期内没有任何回复说明在途请求已丢失，重新补满窗口；运行结束时停止
+  void tick(const std::atomic<bool>& running)
+  {
+    timer_.expires_after(std::chrono::milliseconds(20));
+    timer_.async_wait([this, &running](std::error_code ec) {
+      if (ec) return;
+      if (!running.load(std::memory_order_relaxed))
+      {
+        socket_.stop();
+        return;
+      }
+      if (replies_ == last_replies_) fill_window();
+      last_replies_ = replies_;
+      tick(running);
+    });
+  }
+
+  const Config& cfg_;
+  asio::io_context io_{1};
+  UdpBatchSocket socket_;
+  udp::endpoint server_;
+  std::string request_;
+  asio::steady_timer timer_;
+  const std::atomic<bool>& counting_;
+  std::atomic<std::uint64_t>& done_;
+  std::uint64_t replies_ = 0;
+  std::uint64_t last_replies_ = 0;
+};
+
+struct Result
+{
+  double replies_per_sec = 0;
+  double syscalls_per_datagram = 0;
+};
+
+template <typename Server>
+Result run(const Config& cfg)
+{
+  asio::io_context io(1);
+  Server server(io, cfg);
+  std::thread server_thread([&io] { io.run(); });
+
+  std::atomic<bool> running{true};
+  std::atomic<bool> counting{false};
+  std::atomic<std::uint64_t> done{0};
+  std::vector<std::unique_ptr<Client>> clients;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < cfg.client_threads; ++i) clients.emplace_back(new Client(cfg, server.port(), counting, done));
+  for (auto& c : clients)
+  {
+    Client* p = c.get();
+    threads.emplace_back([p, &running] { p->run(running); });
+  }
+
+  // 预热后开始计数
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  std::uint64_t syscalls_start = 0, syscalls_end = 0;
+  asio::post(io, [&] { syscalls_start = server.syscalls(); });
+  counting.store(true);
+  std::this_thread::sleep_for(cfg.duration);
+  counting.store(false);
+  std::uint64_t replies = done.load();
+  // 在服务器线程上读取统计，然后关闭服务器
+  asio::post(io, [&] {
+    syscalls_end = server.syscalls();
+    server.close();
+  });
+  running.store(false);
+  for (auto& t : threads) t.join();
+  server_thread.join();
+
+  Result r;
+  r.replies_per_sec = static_cast<double>(replies) / cfg.duration.count();
+  r.syscalls_per_datagram = replies ? static_cast<double>(syscalls_end - syscalls_start) / replies : 0;
+  return r;
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  Config cfg;
+  if (argc > 1) cfg.duration = std::chrono::seconds(std::atoi(argv[1]));
+  if (argc > 2) cfg.client_threads = std::atoi(argv[2]);
+  if (argc > 3) cfg.window = static_cast<std::size_t>(std::atoi(argv[3]));
+  if (argc > 4) cfg.batch = static_cast<std::size_t>(std::atoi(argv[4]));
+  if (argc > 5) cfg.size = static_cast<std::size_t>(std::atoi(argv[5]));
+
+  std::cout << "client threads=" << cfg.client_threads << " window=" << cfg.window << " batch=" << cfg.batch
+            << " size=" << cfg.size << "\n";
+  Result plain = run<PlainServer>(cfg);
+  std::cout << "plain: replies/s=" << static_cast<std::uint64_t>(plain.replies_per_sec)
+            << " server syscalls/datagram>=2\n";
+  Result batch = run<BatchServer>(cfg);
+  std::cout << "batch: replies/s=" << static_cast<std::uint64_t>(batch.replies_per_sec)
+            << " server syscalls/datagram=" << batch.syscalls_per_datagram << "\n";
+}
@@ -0,0 +1,160 @@
+/*
+  同机往返延迟对比: 回环 TCP 与本地套接字（AF_UNIX）
+  同一个回显服务器分别监听 127.0.0.1 和一个本地套接字路径，客户端分别用 TcpClient（开启 TCP_NODELAY）
+  和 LocalStreamClient 以相同的分帧与回调做一问一答，每次收到回显后才发下一条，统计单次往返延迟。
+  两者走同一套重连、分帧和回调代码，差异只来自内核协议栈。
+  用法: uds_vs_tcp_latency [iterations=20000] [size=64]
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "network/local_stream_client.h"
+
+using asio::ip::tcp;
+
+namespace
+{
+// 回显服务器: 读到多少回写多少，对两种协议通用
+template <typename Protocol>
+class EchoServer
+{
+ public:
+  EchoServer(asio::io_context& io, const typename Protocol::endpoint& endpoint) : acceptor_(io, endpoint)
+  {
+    start_accept();
+  }
+
+  typename Protocol::endpoint endpoint() const
+  {
+    return acceptor_.local_endpoint();
+  }
+
+ private:
+  struct Session : std::enable_shared_from_this<Session>
+  {
+    explicit Session(typename Protocol::socket s) : socket(std::move(s)) {}
+
+    void start()
+    {
+      auto self = this->shared_from_this();
+      socket.async_read_some(asio::buffer(buf), [self](std::error_code ec, std::size_t n) {
+        if (ec) return;
+        asio::async_write(self->socket, asio::buffer(self->buf, n), [self](std::error_code ec, std::size_t) {
+          if (!ec) self->start();
+        });
+      });
+    }
+
+    typename Protocol::socket socket;
+    char buf[4096];
+  };
+
+  void start_accept()
+  {
+    acceptor_.async_accept([this](std::error_code ec, typename Protocol::socket socket) {
+      if (!ec) std::make_shared<Session>(std::move(socket))->start();
+      start_accept();
+    });
+  }
+
+  typename Protocol::acceptor acceptor_;
+};
+
+// 一问一答测量往返延迟（微秒），前 1/10 为预热不计入
+std::vector<double> run(asio::io_context& io, const std::shared_ptr<TcpClient>& client, int iterations,
+                        std::size_t size)
+{
+  client->set_frame_codec(std::make_shared<FixedSizeCodec>(size));
+
+  const int warmup = iterations / 10;
+  std::vector<double> samples;
+  samples.reserve(iterations);
+  int received = 0;
+  std::chrono::steady_clock::time_point sent_at;
+  const std::string payload(size, 'p');
+
+  auto send_request = [&] {
+    sent_at = std::chrono::steady_clock::now();
+    client->send(payload);
+  };
+
+  client->set_message_view_callback([&](asio::const_buffer) {
+    auto elapsed = std::chrono::steady_clock::now() - sent_at;
+    if (++received > warmup) samples.push_back(std::chrono::duration<double, std::micro>(elapsed).count());
+    if (static_cast<int>(samples.size()) == iterations)
+    {
+      client->stop();
+      io.stop();
+      return;
+    }
+    send_request();
+  });
+  client->set_status_callback([&](TcpClient::Status s, const std::string&) {
+    if (s == TcpClient::Status::Connected) send_request();
+  });
+
+  client->start();
+  io.run();
+  return samples;
+}
+
+void report(const char* name, std::vector<double> samples)
+{
+  if (samples.empty()) return;
+  std::sort(samples.begin(), samples.end());
+  double sum = 0;
+  for (double v : samples) sum += v;
+  std::cout << name << ": n=" << samples.size() << " mean=" << sum / samples.size() << "us"
+            << " p50=" << samples[samples.size() / 2] << "us"
+            << " p99=" << samples[std::min(samples.size() - 1, samples.size() * 99 / 100)] << "us"
+            << " max=" << samples.back() << "us\n";
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  int iterations = argc > 1 ? std::atoi(argv[1]) : 20000;
+  std::size_t size = argc > 2 ? static_cast<std::size_t>(std::atoi(argv[2])) : 64;
+  if (iterations <= 0 || size == 0 || size > 4096)
+  {
+    std::cerr << "usage: uds_vs_tcp_latency [iterations=20000] [size=64(1-4096)]\n";
+    return 1;
+  }
+
+  const std::string path = "/tmp/uds_vs_tcp_latency." + std::to_string(::getpid()) + ".sock";
+  std::remove(path.c_str());
+
+  asio::io_context server_io;
+  EchoServer<tcp> tcp_server(server_io, tcp::endpoint(asio::ip::address_v4::loopback(), 0));
+  EchoServer<asio::local::stream_protocol> uds_server(server_io, asio::local::stream_protocol::endpoint(path));
+  std::thread server_thread([&server_io] { server_io.run(); });
+
+  std::cout << "iterations=" << iterations << " size=" << size << "\n";
+  {
+    asio::io_context io;
+    TcpClient::Options options;
+    options.no_delay = true;
+    auto client =
+      std::make_shared<TcpClient>(io, "127.0.0.1", std::to_string(tcp_server.endpoint().port()), options);
+    report("tcp loopback", run(io, client, iterations, size));
+  }
+  {
+    asio::io_context io;
+    auto client = std::make_shared<LocalStreamClient>(io, path);
+    report("unix socket ", run(io, client, iterations, size));
+  }
+
+  server_io.stop();
+  server_thread.join();
+  std::remove(path.c_str());
+}
@@ -0,0 +1,32 @@
+/*
+  BufferRange: 不拥有数据的 const_buffer 序列，指向一段连续的 asio::const_buffer 数组
+  交给 asio::async_write 时拷贝只复制两个指针，避免聚合写每次复制整个 std::vector<asio::const_buffer>；
+  底层数组在写操作完成前不能修改
+*/
+
+#pragma once
+#include <asio.hpp>
+#include <vector>
+
+class BufferRange
+{
+ public:
+  explicit BufferRange(const std::vector<asio::const_buffer>& bufs) :
+    begin_(bufs.data()), end_(bufs.data() + bufs.size())
+  {
+  }
+
+  const asio::const_buffer* begin() const
+  {
+    return begin_;
+  }
+
+  const asio::const_buffer* end() const
+  {
+    return end_;
+  }
+
+ private:
+  const asio::const_buffer* begin_;
+  const asio::const_buffer* end_;
+};
@@ -0,0 +1,62 @@
+/*
+  ConnectRateLimiter: 挂在 io_context 上的连接速率限制服务（令牌桶），由该 io_context 上所有 TcpClient 共享
+  - 默认不限速；调用 configure() 后，每次发起连接（含重连）前都要先取得一个令牌
+  - 令牌不足时按先来先服务排队，由共享的 TimerWheel 在补充令牌后依次放行
+  - 用于把上游重启后的重连浪潮摊平，避免同时压满对端的 accept 队列和本机的 DNS/握手开销
+------------------------------------------------------------------------------------------
+  ConnectRateLimiter::get(io).configure(200.0, 50);  // 每秒 200 次连接，最多突发 50 次
+------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+#include <asio.hpp>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+#include "network/timer_wheel.h"
+
+// ConnectRateLimiter: 令牌桶连接限速服务
+class ConnectRateLimiter : public asio::io_context::service
+{
+ public:
+  using Clock = std::chrono::steady_clock;
+  using Callback = std::function<void()>;
+
+  static asio::io_context::id id;
+
+  explicit ConnectRateLimiter(asio::io_context& io);
+
+  // 获取 io_context 上的限速器实例
+  static ConnectRateLimiter& get(asio::io_context& io);
+
+  // 设置每秒令牌数和桶容量，rate <= 0 表示不限速（放行所有排队者）
+  void configure(double rate, std::size_t burst);
+
+  // 申请一个令牌：有令牌时立即在当前线程调用 ready，否则排队，稍后在 io 线程中调用
+  void acquire(Callback ready);
+
+  // 正在排队等待令牌的数量
+  std::size_t waiting() const;
+
+ private:
+  void shutdown() override;
+
+  // 以下需持有 mutex_
+  void refill(Clock::time_point now);
+  void schedule();
+
+  // 定时放行排队者
+  void on_timer();
+
+  mutable std::mutex mutex_;
+  TimerWheel& wheel_;
+  TimerWheel::Timer timer_;
+  bool timer_pending_ = false;  // timer_ 是否已启动（受 mutex_ 保护）
+  double rate_ = 0;       // 每秒令牌数，0 表示不限速
+  double burst_ = 0;      // 桶容量
+  double tokens_ = 0;     // 当前令牌数
+  Clock::time_point last_refill_;
+  std::deque<Callback> waiters_;
+};
@@ -0,0 +1,79 @@
+/*
+  CoroTcpClient: TcpClient 的 C++20 协程接口（需使用 -DASIOLEARN_CXX20=ON 构建）
+  - connect() 通过共享的 DnsCache 异步解析，并应用 TcpClient::Options
+  - send() 直接 co_await 写完成；receive_frame() 按 FrameCodec 返回一个完整帧
+  - 错误以 std::system_error 异常抛出（asio::use_awaitable 的默认行为），不自动重连
+  - 协程帧由 asio::awaitable 的 operator new 分配，走 asio 的线程级回收分配器
+    (thread_info_base::awaitable_frame_tag)，稳定收发循环中不会反复 malloc
+------------------------------------------------------------------------------------------
+  asio::awaitable<void> session(asio::io_context& io)
+  {
+    CoroTcpClient client(io, "127.0.0.1", "8080");
+    client.set_frame_codec(std::make_shared<DelimiterCodec>("\n"));
+    co_await client.connect();
+    co_await client.send_frame("hello");
+    std::string_view reply = co_await client.receive_frame();  // 在下一次 receive_frame() 前有效
+  }
+
+  asio::co_spawn(io, session(io), asio::detached);
+------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+#include <asio.hpp>
+
+#if defined(ASIO_HAS_CO_AWAIT)
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "network/dns_cache.h"
+#include "network/frame_codec.h"
+#include "network/receive_buffer.h"
+#include "network/tcp_client.h"
+
+// CoroTcpClient: 协程版 TCP 客户端，同一时刻最多一个 send 和一个 receive_frame 在进行
+class CoroTcpClient
+{
+ public:
+  CoroTcpClient(asio::io_context& io, std::string host, std::string port,
+                const TcpClient::Options& options = TcpClient::Options());
+
+  CoroTcpClient(const CoroTcpClient&) = delete;
+  CoroTcpClient& operator=(const CoroTcpClient&) = delete;
+
+  // 设置分帧编解码器（nullptr 表示每次 receive_frame 返回一次读取到的原始数据）和 DNS 缓存
+  void set_frame_codec(std::shared_ptr<FrameCodec> codec);
+  void set_dns_cache(std::shared_ptr<DnsCache> cache);
+
+  // 解析并连接服务器（已连接时先关闭旧连接）
+  asio::awaitable<void> connect();
+
+  // 写出全部数据
+  asio::awaitable<void> send(asio::const_buffer buf);
+
+  // 按编解码器编码后写出一帧，编解码器无法编码该帧（超长、含分隔符等）时抛出 std::errc::message_size
+  asio::awaitable<void> send_frame(std::string_view payload);
+
+  // 接收一个完整帧，返回的视图指向内部缓冲区，在下一次 receive_frame() 前有效
+  asio::awaitable<std::string_view> receive_frame();
+
+  bool is_open() const;
+  void close();
+
+  asio::ip::tcp::socket& socket();
+
+ private:
+  asio::io_context& io_;
+  asio::ip::tcp::socket socket_;
+  std::string host_, port_;
+  TcpClient::Options options_;
+  std::shared_ptr<DnsCache> dns_cache_;
+  std::shared_ptr<FrameCodec> codec_;
+
+  ReceiveBuffer recv_buf_;  // 接收缓冲区，与 TcpClient 相同的增长与压缩策略
+  std::string send_buf_;   // send_frame 编码缓冲区，复用容量
+};
+
+#endif  // defined(ASIO_HAS_CO_AWAIT)
@@ -0,0 +1,107 @@
+/*
+  DnsCache: 线程安全的异步 DNS 解析缓存，支持 TTL、负缓存和并发查询合并
+  多个 TcpClient 可共享同一个 DnsCache（默认使用进程级共享实例）:
+  - 命中缓存时不再调用 getaddrinfo，直接投递结果
+  - 同一 host:port 同时只有一个解析在进行，其余请求挂起等待该结果
+  - 解析失败的结果同样缓存一段时间(负缓存)，避免重连风暴反复解析
+  - 每次解析都保证完成: 解析所在的 io_context 被销毁时以 operation_aborted 通知等待者；
+    io_context 停止后一直不运行时，超过解析时限的请求重新发起解析，不会永远挂起
+  - 条目数增长到上次清理后的两倍时清理已过期的条目，缓存大小随活跃的 host:port 数量而不是历史总量增长
+------------------------------------------------------------------------------------------
+  auto cache = std::make_shared<DnsCache>(std::chrono::seconds(30), std::chrono::seconds(2));
+  cache->async_resolve(io, "example.com", "80",
+                       [](std::error_code ec, DnsCache::Results results) { ... });
+
+  // 测试时可替换底层解析函数, 使用本地替身代替真实 DNS
+  cache->set_resolve_function([](asio::io_context& io, const std::string& host, const std::string& port,
+                                 DnsCache::Handler handler) { ... });
+------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+#include <asio.hpp>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// DnsCache: 线程安全的异步 DNS 解析缓存
+class DnsCache : public std::enable_shared_from_this<DnsCache>
+{
+ public:
+  using Results = asio::ip::tcp::resolver::results_type;
+  using Handler = std::function<void(std::error_code, Results)>;  // 解析结果回调
+  // 底层解析函数，默认使用 asio::ip::tcp::resolver::async_resolve
+  using ResolveFunction =
+    std::function<void(asio::io_context&, const std::string& host, const std::string& port, Handler)>;
+
+  // 构造函数，传入成功结果的 TTL 和失败结果的负缓存 TTL（需通过 std::make_shared 创建）
+  explicit DnsCache(std::chrono::steady_clock::duration ttl = std::chrono::seconds(60),
+                    std::chrono::steady_clock::duration negative_ttl = std::chrono::seconds(5));
+
+  // 进程级共享实例
+  static std::shared_ptr<DnsCache> shared();
+
+  // 异步解析，handler 总是通过 asio::post 在 io 上调用
+  void async_resolve(asio::io_context& io, const std::string& host, const std::string& port, Handler handler);
+
+  // 同上，解析在 io 上进行，handler 投递到 executor（例如调用者的 strand）
+  // 合并到同一次解析的每个请求都在各自的 executor 上完成，而不是在发起解析的请求所在的线程上
+  void async_resolve(asio::io_context& io, const asio::any_io_executor& executor, const std::string& host,
+                     const std::string& port, Handler handler);
+
+  // 替换底层解析函数（用于测试或自定义解析）
+  void set_resolve_function(ResolveFunction fn);
+
+  // 使某个条目失效
+  void invalidate(const std::string& host, const std::string& port);
+
+  // 清空所有缓存条目（不影响正在进行的解析）
+  void clear();
+
+ private:
+  using Clock = std::chrono::steady_clock;
+  using Key = std::pair<std::string, std::string>;
+
+  struct Waiter
+  {
+    asio::any_io_executor executor;  // 完成时投递 handler 的目标
+    Handler handler;
+  };
+
+  struct Entry
+  {
+    std::error_code ec;                  // 解析结果错误码（负缓存，被取消的解析不缓存）
+    Results results;                     // 解析结果
+    Clock::time_point expires;           // 过期时间
+    bool resolving = false;              // 是否有解析正在进行
+    Clock::time_point resolve_deadline;  // 进行中的解析的时限，超过后新请求重新发起解析
+    std::uint64_t generation = 0;        // 解析序号，用于忽略超时后才完成的旧解析
+    std::vector<Waiter> waiters;         // 等待解析结果的请求
+  };
+
+  // 交给解析函数的完成通知，未被调用就销毁时以 operation_aborted 完成
+  class Completion;
+
+  // 解析完成，写入缓存并通知所有等待者；generation 不是条目当前的解析序号时忽略
+  void complete(const Key& key, std::uint64_t generation, std::error_code ec, Results results);
+
+  // 清理已过期且没有解析在进行的条目（调用时已持有 mutex_）
+  void sweep_expired(Clock::time_point now);
+
+  // 默认解析函数
+  static void default_resolve(asio::io_context& io, const std::string& host, const std::string& port,
+                              Handler handler);
+
+  std::mutex mutex_;
+  std::map<Key, Entry> entries_;
+  std::size_t sweep_at_;  // 条目数达到该值时清理过期条目
+  ResolveFunction resolve_fn_;
+  Clock::duration ttl_;
+  Clock::duration negative_ttl_;
+};
@@ -0,0 +1,118 @@
+/*
+  EndpointSelector: TcpClient 的多端点选择与故障转移决策
+  - 维护每个候选端点的平滑往返时间 srtt = (1 - rtt_gain) * srtt + rtt_gain * 样本和连续失败次数，只做决策，不做 I/O
+  - select(): 每次（重）连接前选择端点，连续失败次数少者优先，其次 srtt 小者优先（尚无样本的端点视为最优，按列表顺序）
+  - on_rtt_sample(): 为当前端点记一个往返样本，返回是否应主动断开并切换到明显更优的端点
+  - 失败只由调用者在连接失败或异常断开时记录（主动切换不算失败）；连接成功后清零，
+    距最近一次失败超过 failure_cooldown 后同样清零，一时故障的端点恢复后仍能被选中或成为切换目标
+  - 线程安全: TcpClient 在其执行器上更新，stats() 可从任意线程读取
+------------------------------------------------------------------------------------------
+  EndpointSelector selector;
+  selector.set_endpoints({{"10.0.0.1", "9000"}, {"10.0.0.2", "9000"}});
+  EndpointSelector::Endpoint ep = selector.select();  // 连接 ep
+  selector.on_connected();                            // 或连接失败时 selector.on_failure()
+  if (selector.on_rtt_sample(rtt_us, srtt_us)) { ... }  // 主动断开，重连时 select() 选中更优的端点
+------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+#include <asio.hpp>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// EndpointSelector: 按失败次数与往返时间选择端点
+class EndpointSelector
+{
+ public:
+  // 服务端端点（主机名或 IP + 端口）
+  struct Endpoint
+  {
+    std::string host;
+    std::string port;
+  };
+
+  // 故障转移与延迟探测策略
+  struct FailoverPolicy
+  {
+    double rtt_gain = 0.125;  // 平滑系数（RFC 6298 的 alpha）
+
+    // 已连接端点的 srtt 超过 rtt_threshold，且存在 srtt * switch_ratio 仍低于它（或尚无样本）的其他端点时，
+    // 主动断开并立即连接那个端点（不等待退避）；rtt_threshold 为 0 表示只在出错时切换
+    std::chrono::milliseconds rtt_threshold{0};
+    double switch_ratio = 1.5;
+
+    // 距最近一次失败超过该时长后清零失败次数，0 表示只在连接成功后清零
+    std::chrono::milliseconds failure_cooldown{30000};
+
+    // 探测帧（由 TcpClient 发送）: 连接期间每隔 ping_interval 发送一次 ping_payload（按分帧编解码器编码），
+    // 收到 is_pong 认可的消息时记一个往返样本，该消息不再交给消息回调；
+    // 到下一个周期仍未收到应答时，以已等待的时间记一个样本（对端卡顿但未断开时 srtt 同样会上升）
+    std::chrono::milliseconds ping_interval{0};  // 0 表示不探测
+    std::string ping_payload;
+    std::function<bool(asio::const_buffer)> is_pong;
+  };
+
+  // 端点状态快照
+  struct EndpointStats
+  {
+    Endpoint endpoint;
+    std::chrono::microseconds srtt{0};  // 平滑往返时间，samples 为 0 时无意义
+    std::uint64_t samples = 0;          // 已计入的往返样本数
+    std::uint32_t failures = 0;         // 连续失败次数（连接成功或冷却后清零）
+    bool current = false;               // 是否为当前（或正在连接的）端点
+  };
+
+  // 替换候选端点列表（列表为空时忽略），统计清零，当前端点回到第一个
+  void set_endpoints(const std::vector<Endpoint>& endpoints);
+
+  // 设置策略，需在开始连接前调用（之后只读，不加锁访问）
+  void set_policy(const FailoverPolicy& policy);
+  const FailoverPolicy& policy() const
+  {
+    return policy_;
+  }
+
+  // 是否没有候选端点（本地套接字客户端）
+  bool empty() const;
+
+  // 选择下一次连接的端点并把它记为当前端点
+  Endpoint select();
+
+  // 当前端点连接成功: 清零其失败次数
+  void on_connected();
+
+  // 当前端点连接失败或异常断开（主动切换不应调用）
+  void on_failure();
+
+  // 为当前端点记一个往返样本（微秒），srtt_us 输出更新后的 srtt；返回是否应切换到更优的端点
+  bool on_rtt_sample(double rtt_us, double& srtt_us);
+
+  // 各端点的往返时间与失败计数
+  std::vector<EndpointStats> stats() const;
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct State
+  {
+    explicit State(const Endpoint& ep) : endpoint(ep) {}
+
+    Endpoint endpoint;
+    double srtt_us = 0;
+    std::uint64_t samples = 0;
+    std::uint32_t failures = 0;
+    Clock::time_point last_failure;  // 最近一次失败时间
+  };
+
+  // 计入冷却后的失败次数（调用时已持有 mutex_）
+  std::uint32_t failures(const State& state, Clock::time_point now) const;
+
+  mutable std::mutex mutex_;
+  std::vector<State> endpoints_;
+  std::size_t current_ = 0;  // 当前（或正在连接的）端点
+  FailoverPolicy policy_;
+};
@@ -0,0 +1,146 @@
+/*
+  FlatIdMap: 以 64 位非零整数为键的开放寻址哈希表（线性探测 + 删除时向后移位，无墓碑）
+  - 所有槽位在一块连续内存中，查找/插入/删除不分配节点，适合大量在途请求的关联表
+  - 键经过斐波那契散列后取高位作为槽位，避免递增 ID 连成一整段探测链（否则删除时向后移位会退化为 O(n)）
+  - 非线程安全，由单个线程（例如 io 线程）访问
+*/
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+template <typename T>
+class FlatIdMap
+{
+ public:
+  explicit FlatIdMap(std::size_t initial_capacity = 64) : size_(0)
+  {
+    std::size_t capacity = 16;
+    while (capacity < initial_capacity) capacity <<= 1;
+    resize(capacity);
+  }
+
+  std::size_t size() const
+  {
+    return size_;
+  }
+
+  bool empty() const
+  {
+    return size_ == 0;
+  }
+
+  // 查找，不存在返回 nullptr
+  T* find(std::uint64_t key)
+  {
+    for (std::size_t i = home(key);; i = (i + 1) & mask_)
+    {
+      if (slots_[i].key == key) return &slots_[i].value;
+      if (slots_[i].key == 0) return nullptr;
+    }
+  }
+
+  // 插入，键已存在时返回 false（key 不能为 0）
+  bool insert(std::uint64_t key, T value)
+  {
+    if ((size_ + 1) * 2 > slots_.size()) grow();  // 负载因子不超过 0.5
+    std::size_t i = home(key);
+    for (; slots_[i].key != 0; i = (i + 1) & mask_)
+    {
+      if (slots_[i].key == key) return false;
+    }
+    slots_[i].key = key;
+    slots_[i].value = std::move(value);
+    ++size_;
+    return true;
+  }
+
+  // 删除并取出值，不存在返回 false
+  bool erase(std::uint64_t key, T* out = nullptr)
+  {
+    std::size_t i = home(key);
+    for (; slots_[i].key != key; i = (i + 1) & mask_)
+    {
+      if (slots_[i].key == 0) return false;
+    }
+    if (out) *out = std::move(slots_[i].value);
+
+    // 向后移位: 把后续探测链上可以前移的元素填补空位
+    for (std::size_t j = (i + 1) & mask_; slots_[j].key != 0; j = (j + 1) & mask_)
+    {
+      std::size_t h = home(slots_[j].key);
+      if (((j - h) & mask_) >= ((j - i) & mask_))
+      {
+        slots_[i].key = slots_[j].key;
+        slots_[i].value = std::move(slots_[j].value);
+        i = j;
+      }
+    }
+    slots_[i].key = 0;
+    slots_[i].value = T();
+    --size_;
+    return true;
+  }
+
+  // 遍历所有元素（遍历期间不能修改表）
+  template <typename F>
+  void for_each(F f)
+  {
+    for (auto& slot : slots_)
+    {
+      if (slot.key != 0) f(slot.key, slot.value);
+    }
+  }
+
+  void swap(FlatIdMap& other)
+  {
+    slots_.swap(other.slots_);
+    std::swap(mask_, other.mask_);
+    std::swap(shift_, other.shift_);
+    std::swap(size_, other.size_);
+  }
+
+ private:
+  struct Slot
+  {
+    std::uint64_t key = 0;  // 0 表示空槽
+    T value;
+  };
+
+  std::size_t home(std::uint64_t key) const
+  {
+    return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ull) >> shift_);
+  }
+
+  void resize(std::size_t capacity)
+  {
+    slots_.clear();
+    slots_.resize(capacity);
+    mask_ = capacity - 1;
+    shift_ = 64;
+    while (capacity > 1)
+    {
+      capacity >>= 1;
+      --shift_;
+    }
+  }
+
+  void grow()
+  {
+    std::vector<Slot> old;
+    old.swap(slots_);
+    resize(old.size() * 2);
+    size_ = 0;
+    for (auto& slot : old)
+    {
+      if (slot.key != 0) insert(slot.key, std::move(slot.value));
+    }
+  }
+
+  std::vector<Slot> slots_;
+  std::size_t mask_;
+  unsigned shift_;  // 64 - log2(容量)
+  std::size_t size_;
+};
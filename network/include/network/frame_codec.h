@@ -0,0 +1,93 @@
+/*
+  FrameCodec: TcpClient 的消息分帧层
+  TcpClient 在接收缓冲区上增量解析，只把完整的帧交给消息回调:
+  - LengthPrefixCodec: 长度前缀帧，前缀为 varint / u16 / u32（大端）
+  - DelimiterCodec:    分隔符帧（例如 "\n" 或 "\r\n"），回调的帧内容不含分隔符
+  - FixedSizeCodec:    固定长度帧
+------------------------------------------------------------------------------------------
+  auto client = std::make_shared<TcpClient>(io, "127.0.0.1", "8080");
+  client->set_frame_codec(std::make_shared<LengthPrefixCodec>(LengthPrefixCodec::Prefix::U32));
+  client->set_message_callback([](const std::string& frame) { ... });  // 每次回调都是一个完整帧
+  client->send_frame("hello");  // 按编解码器添加帧头后发送
+------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <system_error>
+
+// FrameCodec: 分帧编解码器接口，实例带有解析状态，每个连接使用独立实例
+class FrameCodec
+{
+ public:
+  virtual ~FrameCodec() = default;
+
+  // 尝试从 [data, data + size) 的开头解析一个完整帧
+  // 返回本帧消耗的字节数（含帧头/分隔符），0 表示数据不足
+  // 成功时通过 frame/frame_size 输出帧内容在 data 中的位置；帧非法或超长时设置 ec
+  virtual std::size_t decode(const char* data, std::size_t size, const char*& frame, std::size_t& frame_size,
+                             std::error_code& ec) = 0;
+
+  // 将一帧的内容编码后追加到 out
+  // 帧长超过 max_frame_size、帧头无法表示或内容无法按本格式分帧时返回 false，out 保持不变
+  virtual bool encode(const char* data, std::size_t size, std::string& out) const = 0;
+
+  // 重置解析状态（重连后调用）
+  virtual void reset() {}
+};
+
+// LengthPrefixCodec: 长度前缀帧
+class LengthPrefixCodec : public FrameCodec
+{
+ public:
+  enum class Prefix
+  {
+    Varint,  // LEB128 无符号变长整数
+    U16,     // 2 字节大端
+    U32      // 4 字节大端
+  };
+
+  explicit LengthPrefixCodec(Prefix prefix, std::size_t max_frame_size = 16 * 1024 * 1024);
+
+  std::size_t decode(const char* data, std::size_t size, const char*& frame, std::size_t& frame_size,
+                     std::error_code& ec) override;
+  bool encode(const char* data, std::size_t size, std::string& out) const override;
+
+ private:
+  Prefix prefix_;
+  std::size_t max_frame_size_;
+};
+
+// DelimiterCodec: 分隔符帧，记录已扫描位置，数据分多次到达时不会重复扫描
+// 帧内容不能包含分隔符（对端会把它切成两帧），encode() 遇到时返回 false
+class DelimiterCodec : public FrameCodec
+{
+ public:
+  explicit DelimiterCodec(std::string delimiter = "\n", std::size_t max_frame_size = 16 * 1024 * 1024);
+
+  std::size_t decode(const char* data, std::size_t size, const char*& frame, std::size_t& frame_size,
+                     std::error_code& ec) override;
+  bool encode(const char* data, std::size_t size, std::string& out) const override;
+  void reset() override;
+
+ private:
+  std::string delimiter_;
+  std::size_t max_frame_size_;
+  std::size_t scanned_ = 0;  // 当前未完成帧中已扫描过的字节数
+};
+
+// FixedSizeCodec: 固定长度帧，encode() 只接受长度恰好为 frame_size 的内容（不补齐、不拆分）
+class FixedSizeCodec : public FrameCodec
+{
+ public:
+  explicit FixedSizeCodec(std::size_t frame_size);
+
+  std::size_t decode(const char* data, std::size_t size, const char*& frame, std::size_t& frame_size,
+                     std::error_code& ec) override;
+  bool encode(const char* data, std::size_t size, std::string& out) const override;
+
+ private:
+  std::size_t frame_size_;
+};
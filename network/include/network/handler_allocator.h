@@ -0,0 +1,115 @@
+/*
+  HandlerMemory / HandlerAllocator: 每个连接独占的异步处理函数内存池
+  - 通过 asio::bind_allocator 绑定到完成处理函数上，asio 为该操作分配的内部对象（含处理函数本身）都从这里取内存
+  - 固定数量的槽位，同一连接同时在途的操作（读、写、投递、定时器转发）各占一个，稳态读写循环不再调用 malloc
+  - 请求超过槽位大小或槽位用尽时退回全局 operator new，并计入 fallbacks() 便于发现槽位过小
+  - 槽位的占用/归还是原子的，可以在多线程运行的 io_context 上使用
+  - 分配器持有 shared_ptr，保证 io_context 销毁未执行的处理函数（连同其捕获的连接对象）时内存池仍然有效
+  - 仅头文件实现且只依赖标准库，其它模块通过 network_headers 目标引用，无需链接 network 库
+*/
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+class HandlerMemory
+{
+ public:
+  static const std::size_t kSlotSize = 512;  // 单个槽位字节数，覆盖聚合写（async_write）的操作对象
+  static const std::size_t kSlots = 4;       // 同时在途的操作数
+
+  HandlerMemory() : fallbacks_(0)
+  {
+    for (auto& used : in_use_) used.store(false, std::memory_order_relaxed);
+  }
+
+  HandlerMemory(const HandlerMemory&) = delete;
+  HandlerMemory& operator=(const HandlerMemory&) = delete;
+
+  void* allocate(std::size_t size)
+  {
+    if (size <= kSlotSize)
+    {
+      for (std::size_t i = 0; i < kSlots; ++i)
+      {
+        if (!in_use_[i].load(std::memory_order_relaxed) && !in_use_[i].exchange(true, std::memory_order_acquire))
+          return &slots_[i];
+      }
+    }
+    fallbacks_.fetch_add(1, std::memory_order_relaxed);
+    return ::operator new(size);
+  }
+
+  void deallocate(void* p)
+  {
+    const Slot* slot = static_cast<const Slot*>(p);
+    if (slot >= slots_ && slot < slots_ + kSlots)
+    {
+      in_use_[slot - slots_].store(false, std::memory_order_release);
+      return;
+    }
+    ::operator delete(p);
+  }
+
+  // 退回全局 operator new 的次数
+  std::uint64_t fallbacks() const
+  {
+    return fallbacks_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct alignas(std::max_align_t) Slot
+  {
+    unsigned char storage[kSlotSize];
+  };
+
+  Slot slots_[kSlots];
+  std::atomic<bool> in_use_[kSlots];
+  std::atomic<std::uint64_t> fallbacks_;
+};
+
+// 满足标准分配器要求的轻量包装，供 asio::bind_allocator 使用
+template <typename T>
+class HandlerAllocator
+{
+ public:
+  using value_type = T;
+
+  explicit HandlerAllocator(std::shared_ptr<HandlerMemory> memory) : memory_(std::move(memory)) {}
+
+  template <typename U>
+  HandlerAllocator(const HandlerAllocator<U>& other) : memory_(other.memory_)
+  {
+  }
+
+  T* allocate(std::size_t n)
+  {
+    return static_cast<T*>(memory_->allocate(sizeof(T) * n));
+  }
+
+  void deallocate(T* p, std::size_t)
+  {
+    memory_->deallocate(p);
+  }
+
+  template <typename U>
+  bool operator==(const HandlerAllocator<U>& other) const
+  {
+    return memory_ == other.memory_;
+  }
+
+  template <typename U>
+  bool operator!=(const HandlerAllocator<U>& other) const
+  {
+    return memory_ != other.memory_;
+  }
+
+ private:
+  template <typename>
+  friend class HandlerAllocator;
+
+  std::shared_ptr<HandlerMemory> memory_;
+};
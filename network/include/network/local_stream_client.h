@@ -0,0 +1,43 @@
+/*
+  LocalStreamClient: 基于本地流式套接字（AF_UNIX）的 TcpClient，用于连接同机的边车进程
+  - 重连退避、分帧、回调、发送队列、离线缓冲、心跳与指标等行为与 TcpClient 完全相同
+  - 不经过回环 TCP 协议栈，省去校验和、拥塞控制和 ACK 处理；没有 DNS 解析和竞速连接
+  - TCP 层调优选项（TCP_NODELAY、keep-alive、TCP_USER_TIMEOUT、TCP_QUICKACK）被忽略
+  - 仅在支持本地套接字的平台上可用（ASIO_HAS_LOCAL_SOCKETS）
+------------------------------------------------------------------------------------------
+  asio::io_context io;
+  auto client = std::make_shared<LocalStreamClient>(io, "/run/sidecar.sock");
+  client->set_frame_codec(std::make_shared<LengthPrefixCodec>(LengthPrefixCodec::Prefix::U32));
+  client->set_message_callback([](const std::string& msg) { std::cout << msg << "\n"; });
+  client->start();
+  io.run();
+------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+#include <string>
+
+#include "network/tcp_client.h"
+
+#if defined(ASIO_HAS_LOCAL_SOCKETS)
+
+class LocalStreamClient : public TcpClient
+{
+ public:
+  // 构造函数，传入io_context和服务端套接字路径
+  LocalStreamClient(asio::io_context& io, const std::string& path);
+
+  // 构造函数，额外传入套接字选项（只有 SO_SNDBUF / SO_RCVBUF 与 use_strand 生效）
+  LocalStreamClient(asio::io_context& io, const std::string& path, const Options& options);
+
+  // 服务端套接字路径
+  const std::string& path() const
+  {
+    return path_;
+  }
+
+ private:
+  std::string path_;
+};
+
+#endif  // defined(ASIO_HAS_LOCAL_SOCKETS)
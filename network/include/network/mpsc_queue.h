@@ -0,0 +1,86 @@
+/*
+  MpscQueue: 无锁多生产者单消费者队列（Vyukov 非侵入式链表实现）
+  - push() 可在任意线程并发调用，只有一次原子交换，不加锁
+  - pop() 只能由单个消费者线程调用（例如 io_context 线程）
+  - 生产者刚交换完尾指针、尚未链接 next 的瞬间，pop() 可能暂时返回 false，
+    调用方需保证生产者 push 之后还会再通知一次消费者
+  - 每条消息一个链表节点，节点经 Allocator（按节点类型重绑定）分配；例如 TcpClient 使用
+    asio::recycling_allocator，在 io 线程上入队、出队时节点由线程级缓存回收复用，不调用 malloc
+*/
+
+#pragma once
+#include <atomic>
+#include <memory>
+#include <new>
+#include <utility>
+
+template <typename T, typename Allocator = std::allocator<T>>
+class MpscQueue
+{
+ public:
+  explicit MpscQueue(const Allocator& alloc = Allocator()) : alloc_(alloc), head_(create()), tail_(head_) {}
+
+  ~MpscQueue()
+  {
+    T value;
+    while (pop(value))
+    {
+    }
+    destroy(head_);
+  }
+
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+
+  // 入队（多生产者线程安全）
+  void push(T value)
+  {
+    Node* node = create(std::move(value));
+    Node* prev = tail_.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+  }
+
+  // 出队（仅限单个消费者），队列为空时返回 false
+  bool pop(T& out)
+  {
+    Node* next = head_->next.load(std::memory_order_acquire);
+    if (next == nullptr) return false;
+    out = std::move(next->value);
+    destroy(head_);
+    head_ = next;
+    return true;
+  }
+
+ private:
+  struct Node
+  {
+    Node() : next(nullptr) {}
+    explicit Node(T v) : next(nullptr), value(std::move(v)) {}
+
+    std::atomic<Node*> next;
+    T value;
+  };
+
+  using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+  using NodeTraits = std::allocator_traits<NodeAllocator>;
+
+  template <typename... Args>
+  Node* create(Args&&... args)
+  {
+    NodeAllocator alloc(alloc_);
+    Node* node = NodeTraits::allocate(alloc, 1);
+    ::new (static_cast<void*>(node)) Node(std::forward<Args>(args)...);
+    return node;
+  }
+
+  void destroy(Node* node)
+  {
+    NodeAllocator alloc(alloc_);
+    node->~Node();
+    NodeTraits::deallocate(alloc, node, 1);
+  }
+
+  Allocator alloc_;
+  Node* head_;               // 消费者端，指向已出队的哨兵节点
+  std::atomic<Node*> tail_;  // 生产者端
+};
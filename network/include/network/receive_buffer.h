@@ -0,0 +1,68 @@
+/*
+  ReceiveBuffer: 流式连接的接收缓冲区，TcpClient / CoroTcpClient / TcpServer::Session 共用
+  - 一块可增长的连续内存，[data(), data() + size()) 为已接收尚未解析的数据，读操作直接写入尾部的空闲区
+  - prepare() 保证尾部有足够的空闲空间: 先把未解析的数据移到开头，仍不够时扩容
+  - 数据全部消费后读写位置回到开头，稳态收发既不移动数据也不分配内存
+  - 非线程安全，由连接所在的执行器访问
+------------------------------------------------------------------------------------------
+  socket.async_read_some(buffer.prepare(), [&](std::error_code ec, std::size_t n) {
+    buffer.commit(n);
+    // 按编解码器解析 buffer.data() / buffer.size()，每解析出一帧 buffer.consume(帧长)
+  });
+------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+#include <asio.hpp>
+#include <cstddef>
+#include <vector>
+
+class ReceiveBuffer
+{
+ public:
+  // initial_size 为初始容量，不小于每次读取保证的最小空闲空间
+  explicit ReceiveBuffer(std::size_t initial_size = 4096);
+
+  // 保证尾部有足够的空闲空间，返回供读操作写入的区域（在下一次 prepare() / detach() 前有效）
+  asio::mutable_buffer prepare();
+
+  // 读操作向 prepare() 返回的区域写入了 n 字节
+  void commit(std::size_t n)
+  {
+    end_ += n;
+  }
+
+  // 未解析的数据
+  const char* data() const
+  {
+    return buf_.data() + begin_;
+  }
+
+  std::size_t size() const
+  {
+    return end_ - begin_;
+  }
+
+  bool empty() const
+  {
+    return begin_ == end_;
+  }
+
+  // 消费开头的 n 字节；全部消费后读写位置回到开头（不移动数据，已交付的视图仍然有效）
+  void consume(std::size_t n);
+
+  // 丢弃所有未解析的数据（例如重连后）
+  void clear()
+  {
+    begin_ = end_ = 0;
+  }
+
+  // 交出当前的存储，未解析的数据复制到新存储的相同位置，data() 之后的解析不受影响
+  // 用于让回调中已交付的视图在接收缓冲区继续使用时保持有效
+  std::vector<char> detach();
+
+ private:
+  std::vector<char> buf_;
+  std::size_t begin_ = 0;  // 未解析数据起始位置
+  std::size_t end_ = 0;    // 已接收数据结束位置
+};
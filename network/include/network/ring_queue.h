@@ -0,0 +1,80 @@
+/*
+  RingQueue: 环形缓冲区实现的双端队列（容量为 2 的幂，满时翻倍）
+  - 两端入队 / 出队均为 O(1)，出队的槽位原地复用，容量稳定后不再分配内存
+    （std::deque 在队首不断出队、队尾不断入队时会反复释放和分配分块）
+  - 非线程安全，由单个线程（例如 io 线程）访问
+*/
+
+#pragma once
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+template <typename T>
+class RingQueue
+{
+ public:
+  explicit RingQueue(std::size_t initial_capacity = 16)
+  {
+    std::size_t capacity = 16;
+    while (capacity < initial_capacity) capacity <<= 1;
+    slots_.resize(capacity);
+  }
+
+  std::size_t size() const
+  {
+    return size_;
+  }
+
+  bool empty() const
+  {
+    return size_ == 0;
+  }
+
+  T& front()
+  {
+    return slots_[head_];
+  }
+
+  void push_back(T value)
+  {
+    if (size_ == slots_.size()) grow();
+    slots_[(head_ + size_) & (slots_.size() - 1)] = std::move(value);
+    ++size_;
+  }
+
+  void push_front(T value)
+  {
+    if (size_ == slots_.size()) grow();
+    head_ = (head_ - 1) & (slots_.size() - 1);
+    slots_[head_] = std::move(value);
+    ++size_;
+  }
+
+  // 出队并释放元素持有的资源，槽位留待复用
+  void pop_front()
+  {
+    slots_[head_] = T();
+    head_ = (head_ + 1) & (slots_.size() - 1);
+    --size_;
+  }
+
+  void clear()
+  {
+    while (size_) pop_front();
+    head_ = 0;
+  }
+
+ private:
+  void grow()
+  {
+    std::vector<T> bigger(slots_.size() * 2);
+    for (std::size_t i = 0; i < size_; ++i) bigger[i] = std::move(slots_[(head_ + i) & (slots_.size() - 1)]);
+    slots_.swap(bigger);
+    head_ = 0;
+  }
+
+  std::vector<T> slots_;
+  std::size_t head_ = 0;  // 队首槽位
+  std::size_t size_ = 0;  // 元素个数
+};
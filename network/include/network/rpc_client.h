@@ -0,0 +1,97 @@
+/*
+  RpcClient: 基于 TcpClient 的流水线请求/响应客户端
+  - 同一连接上可同时有大量在途请求，响应按关联 ID 匹配，不要求按序返回
+  - 在途请求保存在开放寻址的 FlatIdMap 中，不为每个请求分配节点
+  - 每个请求的超时是挂在 io_context 共享 TimerWheel 上的一个定时器节点，节点嵌入在复用的请求槽中，不单独起 steady_timer
+  - 连接断开时所有在途请求以 connection_reset 失败，stop() 时以 operation_aborted 失败
+
+  线路格式（请求与响应相同）: [u32 大端帧长度][u64 大端请求 ID][负载]，服务端需原样带回请求 ID
+------------------------------------------------------------------------------------------
+  auto rpc = RpcClient::create(io, "127.0.0.1", "9000");
+  rpc->start();
+  rpc->async_request("ping", std::chrono::milliseconds(200), [](std::error_code ec, const std::string& resp) {
+    if (ec == asio::error::timed_out) { ... }
+  });
+------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+#include <asio.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "network/flat_id_map.h"
+#include "network/tcp_client.h"
+#include "network/timer_wheel.h"
+
+// RpcClient: 流水线 RPC 客户端
+class RpcClient : public std::enable_shared_from_this<RpcClient>
+{
+ public:
+  using Handler = std::function<void(std::error_code, const std::string&)>;  // 响应回调(错误码, 响应负载)
+
+  static std::shared_ptr<RpcClient> create(asio::io_context& io, const std::string& host, const std::string& port);
+  static std::shared_ptr<RpcClient> create(asio::io_context& io, const std::string& host, const std::string& port,
+                                           const TcpClient::Options& socket_options);
+
+  RpcClient(const RpcClient&) = delete;
+  RpcClient& operator=(const RpcClient&) = delete;
+
+  void start();
+  void stop();  // 停止连接，所有在途请求以 operation_aborted 失败
+
+  // 发起请求（线程安全），handler 在底层 TcpClient 的执行器上调用且只调用一次
+  // 超时精度为 TimerWheel::resolution()
+  // 请求超过最大帧长时返回 asio::error::message_size，发送队列已满时返回 asio::error::no_buffer_space
+  // 超时返回 asio::error::timed_out，连接断开返回 asio::error::connection_reset，未连接时立即返回 not_connected
+  void async_request(std::string payload, std::chrono::steady_clock::duration deadline, Handler handler);
+
+  // 设置底层连接的状态回调
+  void set_status_callback(TcpClient::StatusCallback cb);
+
+  // 当前在途请求数（线程安全）
+  std::size_t in_flight() const;
+
+  // 访问底层连接（例如查询指标）
+  std::shared_ptr<TcpClient> client() const;
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  // 在途请求槽，地址稳定（定时器节点不可移动），请求完成后放回空闲列表复用
+  struct Pending
+  {
+    Handler handler;
+    TimerWheel::Timer timer;  // 超时定时器
+  };
+
+  RpcClient(asio::io_context& io, const std::string& host, const std::string& port,
+            const TcpClient::Options& socket_options);
+
+  // 以下均在底层 TcpClient 的执行器上执行（启用 use_strand 时与收发回调串行）
+  void do_request(std::string& payload, Clock::duration deadline, Handler& handler);
+  void on_frame(asio::const_buffer frame);
+  void on_status(TcpClient::Status s, const std::string& info);
+  void on_timeout(std::uint64_t id);
+  void fail_all(std::error_code ec);
+  // 取出请求的回调并释放其槽位，请求不存在（已完成或已超时）时返回空
+  Handler take(std::uint64_t id);
+
+  std::shared_ptr<TcpClient> client_;
+  TimerWheel& wheel_;  // io_context 共享的时间轮
+
+  std::deque<Pending> slots_;               // 请求槽
+  std::vector<std::size_t> free_slots_;     // 空闲槽下标
+  FlatIdMap<std::size_t> pending_;          // 在途请求表: 请求 ID -> 槽下标
+  std::uint64_t next_id_ = 1;               // 下一个请求 ID
+  std::atomic<std::size_t> in_flight_{0};
+  std::atomic<bool> stopped_{false};        // stop() 已调用
+
+  TcpClient::StatusCallback on_status_;
+};
@@ -0,0 +1,232 @@
+/*
+  SessionPool: 固定大小 slab 上的会话对象池，配合侵入式非原子引用计数 SessionRef 使用
+  - 对象按 slab（每块 slab_size 个）成批分配，首次取用时就地构造，之后不再析构而是回收复用:
+    引用计数归零时调用 T::reset()（关闭套接字、清理状态），对象回到空闲链表，下次 acquire() 直接取出，
+    其中的 tcp::socket 等成员对象随之复用，短连接不再为每个连接 new/delete 一次会话
+  - SessionRef 的引用计数是普通整数，处理函数复制引用只做一次非原子加减，代替 shared_ptr 的原子操作
+  - 非线程安全: 池和其中的会话必须固定在同一个线程上（例如只在一个线程上运行的 io_context）
+  - 池析构时析构所有对象，此前所有 SessionRef 必须已经释放: 先关闭接受器并用 for_each() 关闭所有会话，
+    再运行 io_context 让被取消的处理函数执行完（不能先析构 io_context，池中的套接字必须先于它析构）
+------------------------------------------------------------------------------------------
+  class Connection : public PooledSession<Connection>
+  {
+   public:
+    explicit Connection(asio::io_context& io) : socket_(io) {}
+    void reset() { std::error_code ec; socket_.close(ec); }  // 回收时调用
+    tcp::socket socket_;
+  };
+
+  SessionPool<Connection> pool(64, [&io](void* p) { return new (p) Connection(io); });
+  SessionRef<Connection> conn = pool.acquire();
+  acceptor.async_accept(conn->socket_, [conn](std::error_code ec) { ... });  // 复制 conn 只做非原子加一
+------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+template <typename T>
+class SessionPool;
+
+template <typename T>
+class SessionRef;
+
+// 池化会话的基类，保存侵入式引用计数和空闲链表指针
+template <typename T>
+class PooledSession
+{
+ public:
+  PooledSession() = default;
+  PooledSession(const PooledSession&) = delete;
+  PooledSession& operator=(const PooledSession&) = delete;
+
+  // 当前引用数
+  std::uint32_t use_count() const
+  {
+    return refs_;
+  }
+
+  // 在会话自身的成员函数里取得一个引用（相当于 shared_from_this）
+  SessionRef<T> self()
+  {
+    return SessionRef<T>(static_cast<T*>(this));
+  }
+
+ protected:
+  ~PooledSession() = default;
+
+ private:
+  friend class SessionPool<T>;
+  friend class SessionRef<T>;
+
+  std::uint32_t refs_ = 0;
+  SessionPool<T>* pool_ = nullptr;
+  T* next_free_ = nullptr;
+};
+
+// 侵入式会话引用（非原子），引用计数归零时把对象交还给池
+template <typename T>
+class SessionRef
+{
+ public:
+  SessionRef() = default;
+
+  explicit SessionRef(T* p) : p_(p)
+  {
+    if (p_) ++p_->refs_;
+  }
+
+  SessionRef(const SessionRef& other) : SessionRef(other.p_) {}
+
+  SessionRef(SessionRef&& other) noexcept : p_(other.p_)
+  {
+    other.p_ = nullptr;
+  }
+
+  SessionRef& operator=(SessionRef other) noexcept
+  {
+    std::swap(p_, other.p_);
+    return *this;
+  }
+
+  ~SessionRef()
+  {
+    if (p_ && --p_->refs_ == 0) p_->pool_->recycle(p_);
+  }
+
+  T* get() const
+  {
+    return p_;
+  }
+
+  T* operator->() const
+  {
+    return p_;
+  }
+
+  T& operator*() const
+  {
+    return *p_;
+  }
+
+  explicit operator bool() const
+  {
+    return p_ != nullptr;
+  }
+
+ private:
+  T* p_ = nullptr;
+};
+
+template <typename T>
+class SessionPool
+{
+ public:
+  // 在给定存储上就地构造一个新对象
+  using Constructor = std::function<T*(void*)>;
+
+  SessionPool(std::size_t slab_size, Constructor construct) :
+    slab_size_(slab_size > 0 ? slab_size : 1), construct_(std::move(construct))
+  {
+  }
+
+  ~SessionPool()
+  {
+    for (std::size_t i = 0; i < slabs_.size(); ++i)
+    {
+      std::size_t count = i + 1 == slabs_.size() ? used_ : slab_size_;
+      for (std::size_t j = 0; j < count; ++j) reinterpret_cast<T*>(&slabs_[i][j])->~T();
+    }
+  }
+
+  SessionPool(const SessionPool&) = delete;
+  SessionPool& operator=(const SessionPool&) = delete;
+
+  // 取出一个会话: 优先复用空闲对象，否则在当前 slab 上构造新对象（slab 用完时分配新 slab）
+  SessionRef<T> acquire()
+  {
+    T* p = free_;
+    if (p)
+    {
+      free_ = p->next_free_;
+      p->next_free_ = nullptr;
+      ++reused_;
+    }
+    else
+    {
+      if (slabs_.empty() || used_ == slab_size_)
+      {
+        slabs_.emplace_back(new Storage[slab_size_]);
+        used_ = 0;
+      }
+      p = construct_(&slabs_.back()[used_]);
+      ++used_;
+      ++constructed_;
+      p->pool_ = this;
+    }
+    ++in_use_;
+    return SessionRef<T>(p);
+  }
+
+  // 对每个已构造的对象（含空闲的）调用 fn(T&)，例如关闭前取消所有会话上的异步操作
+  template <typename F>
+  void for_each(F fn)
+  {
+    for (std::size_t i = 0; i < slabs_.size(); ++i)
+    {
+      std::size_t count = i + 1 == slabs_.size() ? used_ : slab_size_;
+      for (std::size_t j = 0; j < count; ++j) fn(*reinterpret_cast<T*>(&slabs_[i][j]));
+    }
+  }
+
+  // 已构造的对象数 / 正在使用的对象数 / slab 数 / 复用次数
+  std::size_t constructed() const
+  {
+    return constructed_;
+  }
+
+  std::size_t in_use() const
+  {
+    return in_use_;
+  }
+
+  std::size_t slabs() const
+  {
+    return slabs_.size();
+  }
+
+  std::uint64_t reused() const
+  {
+    return reused_;
+  }
+
+ private:
+  friend class SessionRef<T>;
+
+  using Storage = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+  // 引用计数归零: 清理状态后放回空闲链表
+  void recycle(T* p)
+  {
+    p->reset();
+    p->next_free_ = free_;
+    free_ = p;
+    --in_use_;
+  }
+
+  std::size_t slab_size_;
+  Constructor construct_;
+  std::vector<std::unique_ptr<Storage[]>> slabs_;
+  std::size_t used_ = 0;  // 最后一个 slab 中已构造的对象数
+  T* free_ = nullptr;     // 空闲链表
+  std::size_t constructed_ = 0;
+  std::size_t in_use_ = 0;
+  std::uint64_t reused_ = 0;
+};
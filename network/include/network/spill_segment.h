@@ -0,0 +1,81 @@
+/*
+  SpillSegment: 环形的内存映射溢出段，用于 TcpClient 离线时把超出内存上限的消息落盘
+  - 文件按容量一次性 ftruncate（稀疏文件，只占用实际写入的磁盘空间）并以 MAP_SHARED 映射
+  - 记录格式为 [u32 长度][数据]，append() 只做一次 memcpy，页面由内核按需换出，不占用进程堆
+  - 按写入顺序读出: peek() 返回直接指向映射区的缓冲区，可直接交给聚合写；写完后 consume()
+  - 每条记录在映射区中连续存放；尾部放不下时写入回绕标记并从头部已消费的空间继续写，
+    consume() 释放的空间随即可以复用，不必等整个段消费完；close() 解除映射并删除文件
+  - 非线程安全，由单个线程（TcpClient 的执行器）访问；非 POSIX 平台上 open() 返回 operation_not_supported
+------------------------------------------------------------------------------------------
+  SpillSegment spill;
+  std::error_code ec;
+  if (spill.open("/var/tmp/client.spill", 256 * 1024 * 1024, ec)) spill.append(data, size);
+  std::vector<asio::const_buffer> bufs;
+  std::size_t n = spill.peek(64, bufs);  // 写出 bufs 后
+  spill.consume(n);
+------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+#include <asio.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <system_error>
+#include <vector>
+
+class SpillSegment
+{
+ public:
+  SpillSegment();
+  ~SpillSegment();
+
+  SpillSegment(const SpillSegment&) = delete;
+  SpillSegment& operator=(const SpillSegment&) = delete;
+
+  // 创建（截断已有的）段文件并映射 capacity 字节
+  bool open(const std::string& path, std::size_t capacity, std::error_code& ec);
+  void close();
+  bool is_open() const;
+
+  // 追加一条记录，空闲空间（不计已消费后可复用的部分）不足时返回 false
+  bool append(const char* data, std::size_t size);
+
+  // 从读位置起取最多 max_records 条记录追加到 out，返回取到的条数（不移动读位置）
+  std::size_t peek(std::size_t max_records, std::vector<asio::const_buffer>& out) const;
+
+  // 丢弃读位置起的 records 条记录
+  void consume(std::size_t records);
+
+  bool empty() const
+  {
+    return records_ == 0;
+  }
+
+  // 未消费的记录数 / 数据字节数（不含长度前缀）
+  std::size_t records() const
+  {
+    return records_;
+  }
+
+  std::size_t bytes() const
+  {
+    return bytes_;
+  }
+
+ private:
+  // 读取 offset 处记录的长度；记录回绕到段首时把 offset 改为 0
+  std::uint32_t record_at(std::size_t& offset) const;
+
+  std::string path_;
+  char* base_ = nullptr;      // 映射起始地址
+  std::size_t capacity_ = 0;  // 映射大小
+  std::size_t read_ = 0;      // 下一条待读记录的偏移
+  std::size_t write_ = 0;     // 下一条记录的写入偏移
+  bool wrapped_ = false;      // 写位置已回绕到读位置之前: 数据为 [read_, 回绕点) + [0, write_)
+  std::size_t records_ = 0;
+  std::size_t bytes_ = 0;
+#if !defined(_WIN32)
+  int fd_ = -1;
+#endif
+};
@@ -50,10 +50,24 @@
 #include <array>
 #include <asio.hpp>
 #include <atomic>
-#include <deque>
+#include <condition_variable>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
+
+#include "network/connect_rate_limiter.h"
+#include "network/dns_cache.h"
+#include "network/endpoint_selector.h"
+#include "network/frame_codec.h"
+#include "network/handler_allocator.h"
+#include "network/mpsc_queue.h"
+#include "network/receive_buffer.h"
+#include "network/ring_queue.h"
+#include "network/spill_segment.h"
+#include "network/tcp_client_metrics.h"
+#include "network/timer_wheel.h"
 
 // TcpClient: 异步 TCP 客户端，支持自动重连、消息回调和状态查询
 class TcpClient : public std::enable_shared_from_this<TcpClient>
@@ -68,11 +82,90 @@ class TcpClient : public std::enable_shared_from_this<TcpClient>
     Reconnecting   // 正在重连
   };
 
+  // 发送队列超限时的处理策略
+  enum class OverflowPolicy
+  {
+    Reject,      // 拒绝新消息，send() 返回 false
+    DropOldest,  // 丢弃最早的未发送消息
+    Block        // 阻塞调用线程直到队列有空间（在 io 线程中调用时退化为 Reject）
+  };
+
+  // 发送队列限制，数值为 0 表示不限制/不启用
+  struct SendQueueLimits
+  {
+    std::size_t max_bytes = 0;       // 队列最大字节数
+    std::size_t max_messages = 0;    // 队列最大消息数
+    std::size_t high_watermark = 0;  // 高水位（字节），超过时触发水位回调
+    std::size_t low_watermark = 0;   // 低水位（字节），越过高水位后回落到此值以下时触发水位回调
+    OverflowPolicy policy = OverflowPolicy::Reject;
+  };
+
+  // 客户端选项
+  // 套接字调优项在每次（重）连接成功后应用；数值为 0 / false 表示保持系统默认
+  // 不支持的选项（例如非 Linux 平台上的 TCP_USER_TIMEOUT / TCP_QUICKACK）会被忽略
+  struct Options
+  {
+    // 所有内部处理函数经由 asio::strand 串行执行，使客户端可以用在多线程运行的 io_context 上
+    // 关闭时（默认）直接使用 io_context 的执行器，仅适用于 io_context 只在一个线程上运行的情况
+    bool use_strand = false;
+
+    // 竞速连接（Happy Eyeballs, RFC 8305）: 解析结果按地址族交错排列（上次成功的地址族优先），
+    // 每隔 happy_eyeballs_delay_ms 或上一个尝试失败时发起下一个连接，取最先成功的一个并取消其余；
+    // 关闭时按解析顺序逐个尝试（asio::async_connect），不可达的首地址会让每次重连都等满 SYN 超时
+    bool happy_eyeballs = false;
+    int happy_eyeballs_delay_ms = 250;
+
+    bool no_delay = false;            // TCP_NODELAY，关闭 Nagle 算法
+    int send_buffer_size = 0;         // SO_SNDBUF（字节）
+    int receive_buffer_size = 0;      // SO_RCVBUF（字节）
+    bool keep_alive = false;          // SO_KEEPALIVE
+    int keep_alive_idle = 0;          // TCP_KEEPIDLE，空闲多久开始探测（秒）
+    int keep_alive_interval = 0;      // TCP_KEEPINTVL，探测间隔（秒）
+    int keep_alive_count = 0;         // TCP_KEEPCNT，探测失败多少次判定断开
+    unsigned user_timeout_ms = 0;     // TCP_USER_TIMEOUT，已发送数据多久未被确认即断开（毫秒）
+    bool quick_ack = false;           // TCP_QUICKACK，每次读取后重新开启（该选项不是持久的）
+  };
+
+  // 重连退避策略
+  // jitter 为 true 时使用去相关抖动: 下次延迟 = min(max_delay, 随机[base, 上次延迟 * 3])，
+  // 避免大量客户端在上游重启后以相同节奏同时重连；为 false 时按 base、2*base、4*base... 翻倍
+  struct ReconnectPolicy
+  {
+    std::chrono::milliseconds base{1000};       // 初始延迟
+    std::chrono::milliseconds max_delay{30000}; // 最大延迟
+    bool jitter = true;                         // 是否使用去相关抖动
+  };
+
+  // 离线缓冲策略（默认关闭）
+  // 未连接期间消息总是留在内存中（见 send()）；启用后离线期间内存中待发字节数将超过 memory_limit 时
+  // 新消息追加到内存映射的溢出段文件（见 SpillSegment），不再占用堆。重连后先发内存中的消息，
+  // 再按顺序经聚合写回放溢出段；溢出段非空期间的新消息在内存中排在段后，段回放完再发
+  // 已被 send() 接受的消息不会因溢出段写满而丢弃: 写不下的消息留在内存中，继续占用发送队列配额
+  // spill_path 为空时不落盘，离线期间 memory_limit 按发送队列字节上限执行（超限处理见 SendQueueLimits::policy）
+  struct OfflinePolicy
+  {
+    bool enabled = false;
+    std::size_t memory_limit = 4 * 1024 * 1024;      // 离线时内存中缓冲的字节数上限
+    std::string spill_path;                          // 溢出段文件路径，为空时不落盘（消息留在内存）
+    std::size_t spill_capacity = 256 * 1024 * 1024;  // 溢出段容量，环形复用已回放的空间
+  };
+
+  // 多端点故障转移与按延迟选路（见 set_endpoints），选择与切换决策由 EndpointSelector 完成
+  using Endpoint = EndpointSelector::Endpoint;
+  using FailoverPolicy = EndpointSelector::FailoverPolicy;
+  using EndpointStats = EndpointSelector::EndpointStats;
+
   using MessageCallback = std::function<void(const std::string&)>;         // 收到消息回调
+  using MessageViewCallback = std::function<void(asio::const_buffer)>;    // 收到消息回调（借用视图，零拷贝）
   using StatusCallback = std::function<void(Status, const std::string&)>;  // 状态变化回调
+  using FlushCallback = std::function<void(std::size_t, std::size_t)>;     // 一次聚合写完成回调(消息数, 字节数)
+  using WatermarkCallback = std::function<void(bool, std::size_t)>;         // 水位回调(是否高水位, 当前队列字节数)
 
   // 构造函数，传入io_context、服务器host和port
   TcpClient(asio::io_context& io, const std::string& host, const std::string& port);
+
+  // 构造函数，额外传入套接字调优选项
+  TcpClient(asio::io_context& io, const std::string& host, const std::string& port, const Options& options);
   ~TcpClient() = default;
 
   // 启动客户端连接
@@ -81,52 +174,251 @@ class TcpClient : public std::enable_shared_from_this<TcpClient>
   // 停止客户端，关闭连接并取消重连
   void stop();
 
-  // 设置收到消息时的回调
+  // 设置收到消息时的回调（设置了分帧编解码器时每次回调一个完整帧，否则为一次读取到的原始数据）
   void set_message_callback(MessageCallback cb);
 
+  // 设置零拷贝的消息回调：视图指向内部接收缓冲区，仅在回调期间有效
+  // 只设置该回调时不会为每条消息构造 std::string
+  void set_message_view_callback(MessageViewCallback cb);
+
+  // 在消息视图回调内调用：接管当前接收缓冲区的所有权，使回调收到的视图在返回值存活期间保持有效
+  // 客户端会为后续读取换用新的缓冲区，不复制已交付的数据
+  std::shared_ptr<const std::vector<char>> retain_received();
+
+  // 设置分帧编解码器（nullptr 表示不分帧），需在 start() 前调用
+  void set_frame_codec(std::shared_ptr<FrameCodec> codec);
+
   // 设置状态变化时的回调
   void set_status_callback(StatusCallback cb);
 
+  // 设置每次聚合写完成时的回调，报告本次写出的消息数和字节数
+  void set_flush_callback(FlushCallback cb);
+
+  // 设置候选端点列表（替换构造时传入的 host/port，列表为空时忽略），需在 start() 前调用
+  // 连接失败或断开后重连时按 FailoverPolicy 重新选择端点；本地套接字客户端不支持
+  void set_endpoints(const std::vector<Endpoint>& endpoints);
+
+  // 设置故障转移与延迟探测策略，需在 start() 前调用
+  void set_failover_policy(const FailoverPolicy& policy);
+
+  // 各端点的往返时间与失败计数（线程安全）
+  std::vector<EndpointStats> endpoint_stats() const;
+
+  // 设置 DNS 解析缓存（默认使用进程级共享的 DnsCache::shared()），需在 start() 前调用
+  void set_dns_cache(std::shared_ptr<DnsCache> cache);
+
+  // 设置心跳：连接期间若一个周期内没有写出任何数据，则原样发送 payload（interval 为 0 表示关闭），需在 start() 前调用
+  void set_heartbeat(std::chrono::milliseconds interval, std::string payload);
+
+  // 设置读空闲超时：连续一个超时周期内没有收到任何数据则断开并重连（0 表示关闭），需在 start() 前调用
+  // 按周期检查，实际断开发生在最后一次收到数据后的 timeout ~ 2 * timeout 之间
+  void set_idle_timeout(std::chrono::milliseconds timeout);
+
+  // 设置重连退避策略，需在 start() 前调用
+  // 连接速率另受 io_context 上共享的 ConnectRateLimiter 约束（默认不限速）
+  void set_reconnect_policy(const ReconnectPolicy& policy);
+
+  // 设置发送队列限制，需在 start() 前调用
+  void set_send_queue_limits(const SendQueueLimits& limits);
+
+  // 设置离线缓冲策略，需在 start() 前调用
+  // memory_limit 应小于 SendQueueLimits::max_bytes，否则消息在落盘前就会被发送队列限制拒绝
+  void set_offline_policy(const OfflinePolicy& policy);
+
+  // 设置高/低水位回调；高水位回调在触发越限的 send() 调用线程中执行，低水位回调在 io 线程中执行
+  void set_watermark_callback(WatermarkCallback cb);
+
+  // 当前发送队列中的字节数和消息数（含已投递但尚未写出的消息，不含已落盘的消息，线程安全）
+  std::size_t queued_bytes() const;
+  std::size_t queued_messages() const;
+
+  // 把调优选项应用到一个已连接的套接字（尽力而为，单个选项失败不影响连接）
+  static void apply_socket_options(asio::ip::tcp::socket& socket, const Options& options);
+
+  // 客户端内部处理函数使用的执行器（启用 use_strand 时为 strand）
+  asio::any_io_executor get_executor() const;
+
+  // 异步处理函数内存池退回全局 operator new 的次数，稳态读写循环中应保持不变
+  std::uint64_t handler_fallbacks() const;
+
+  // 抓取连接指标快照（无锁，可在任意线程定期调用）
+  TcpClientMetrics::Snapshot metrics() const;
+
   // 线程安全状态查询
   Status get_status() const;
 
   // 是否链接成功
   bool is_connected() const;
 
-  // 发送数据（线程安全）
-  void send(const std::string& msg);
+  // 发送数据（线程安全），因队列超限被拒绝时返回 false
+  // 消息直接进入无锁队列，只有队列由空变为非空时才向 io_context 投递一次处理
+  // 未连接（连接中、等待重连）时不发起写，消息留在队列中，连接成功后按顺序发出；不会因此产生
+  // "Write error" 状态或额外的重连。断线期间的积压只受 SendQueueLimits 限制，另见 OfflinePolicy
+  bool send(const std::string& msg);
+  bool send(std::string&& msg);
+
+  // 按分帧编解码器编码后发送一帧（线程安全），未设置编解码器时等同于 send()
+  // 编解码器无法编码该帧（超过最大帧长或长度前缀能表示的范围、含分隔符、不等于固定帧长）时不发送并返回 false
+  bool send_frame(const std::string& payload);
+
+ protected:
+  // 连接到一个固定的流式套接字端点（例如 AF_UNIX 路径），不经过 DNS 解析和竞速连接，
+  // 仅应用与协议无关的套接字选项（SO_SNDBUF / SO_RCVBUF）；见 LocalStreamClient
+  TcpClient(asio::io_context& io, const asio::generic::stream_protocol::endpoint& endpoint, const Options& options);
 
  private:
+  using Socket = asio::generic::stream_protocol::socket;
+
+  TcpClient(asio::io_context& io, const std::string& host, const std::string& port, const Options& options,
+            bool local);
+
+  // 应用调优选项；tcp_level 为 false 时跳过 TCP 层选项
+  template <typename SocketType>
+  static void apply_options(SocketType& socket, const Options& options, bool tcp_level);
+
   // 设置状态并触发状态回调
   void set_status(Status s, const std::string& info);
 
-  // 执行连接操作
+  // 执行连接操作（取得连接令牌后异步解析 + 异步连接）
   void do_connect();
+  void do_resolve_and_connect();
+  void on_resolved(std::error_code ec, const DnsCache::Results& endpoints);
+  void on_connected();
+  void on_connect_failed(const std::error_code& ec);
+
+  // 竞速连接: 按地址族交错排序后错时发起，第一个成功的套接字移入 socket_
+  struct ConnectRace;
+  void start_race(const DnsCache::Results& endpoints);
+  void launch_attempt(const std::shared_ptr<ConnectRace>& race);
+  void on_attempt(const std::shared_ptr<ConnectRace>& race, std::size_t index, const std::error_code& ec);
+  void abort_race();
+
+  // 计算下一次重连延迟
+  std::chrono::milliseconds next_reconnect_delay();
 
   // 计划重连（指数退避）
   void schedule_reconnect();
 
+  // 连接建立后启动心跳和读空闲检测，连接断开时取消
+  void start_keepalive_timers();
+  void cancel_timers();
+
+  // 绑定到所有完成处理函数上的分配器，使用连接独占的内存池
+  HandlerAllocator<void> handler_allocator() const;
+
+  // 启动时间轮定时器，到期后在客户端执行器上执行 fn
+  void arm_timer(TimerWheel::Timer& timer, std::chrono::steady_clock::duration delay, std::function<void()> fn);
+
+  void on_heartbeat_timer();
+  void on_idle_timer();
+
+  // 故障转移: 记录往返样本（微秒），EndpointSelector 判定需要切换时主动断开
+  void on_rtt_sample(double rtt_us);
+  void on_ping_timer();
+  bool consume_pong(const char* data, std::size_t size);
+
   // 异步读取数据
   void do_read();
 
-  // 异步写入数据
+  // 从接收缓冲区中解析并分发消息，出错返回 false
+  bool dispatch_received();
+
+  // 把一条消息交给消息回调
+  void deliver(const char* data, std::size_t size);
+
+  // 异步写入数据：将当前队列中的消息聚合为一次 scatter-gather 写
+  // 内存队列为空时直接以溢出段中的记录（指向映射区）作为缓冲区回放；未连接时不写
   void do_write();
 
+  // 把无锁发送队列中的消息移入写队列（io 线程）
+  void drain_send_queue();
+
+  // 为一条新消息预留队列配额，超限且策略不允许时返回 false
+  bool reserve_queue(std::size_t bytes);
+
+  // 释放已写出或被丢弃消息占用的配额
+  void release_queue(std::size_t messages, std::size_t bytes);
+
+  // DropOldest 策略下丢弃最早的未发送消息直到不再超限
+  void drop_oldest();
+
+  // 离线缓冲: 当前消息是否应写入溢出段；写入（首次使用时创建段文件，先写入排在段后的内存消息），
+  // 段文件不可用或已写满时返回 false，消息留在内存中
+  bool should_spill(std::size_t size) const;
+  bool spill(const std::string& msg);
+
+  // 内存中的消息入队: 溢出段非空时排在段后
+  void enqueue_memory(std::string msg);
+
+  // 队列是否超过限制
+  bool over_limit(std::size_t messages, std::size_t bytes) const;
+
   // 关闭连接
   void close();
 
  private:
   asio::io_context& io_;                // ASIO IO上下文
-  asio::ip::tcp::socket socket_;        // TCP套接字
-  asio::steady_timer timer_;            // 重连定时器
-  std::string host_, port_;             // 服务器地址和端口
-  std::array<char, 1024> read_buf_;     // 读缓冲区
-  std::deque<std::string> write_msgs_;  // 待发送消息队列
+  asio::any_io_executor executor_;      // 内部处理函数的执行器（io_context 执行器或 strand）
+  Socket socket_;                       // 流式套接字（TCP 或本地套接字）
+  TimerWheel& wheel_;                   // io_context 共享的时间轮
+  TimerWheel::Timer reconnect_timer_;   // 重连退避定时器
+  std::atomic<bool> reconnect_pending_{false};  // 是否已计划重连（读写同时失败时只计划一次）
+  TimerWheel::Timer heartbeat_timer_;   // 心跳定时器
+  TimerWheel::Timer idle_timer_;        // 读空闲检测定时器
+  std::chrono::milliseconds heartbeat_interval_{0};  // 心跳周期
+  std::string heartbeat_payload_;                    // 心跳内容
+  std::chrono::milliseconds idle_timeout_{0};        // 读空闲超时
+  std::uint64_t heartbeat_mark_ = 0;                 // 上个心跳周期结束时的已写出字节数
+  std::uint64_t idle_mark_ = 0;                      // 上个空闲检测周期结束时的已接收字节数
+  EndpointSelector endpoints_;          // 候选端点与故障转移决策（本地套接字客户端为空）
+  TimerWheel::Timer ping_timer_;        // 探测帧定时器
+  std::chrono::steady_clock::time_point connect_started_;  // 本次连接发起时间
+  std::chrono::steady_clock::time_point ping_sent_;        // 未应答探测帧的发送时间
+  bool ping_outstanding_ = false;
+  bool switching_ = false;              // 主动切换端点中: 立即重连，不计为端点失败，断开不再报告错误
+  Options options_;                     // 客户端选项
+  bool local_ = false;                  // 是否连接固定的本地端点（不解析、不竞速）
+  asio::generic::stream_protocol::endpoint local_endpoint_;  // 本地端点
+  std::shared_ptr<ConnectRace> race_;   // 进行中的竞速连接
+  int preferred_family_ = 0;            // 上次竞速胜出的地址族（AF_INET / AF_INET6），0 表示未知
+  std::shared_ptr<DnsCache> dns_cache_;  // DNS 解析缓存
+  ReceiveBuffer recv_buf_;              // 接收缓冲区
+  std::shared_ptr<FrameCodec> codec_;   // 分帧编解码器
+  std::shared_ptr<const std::vector<char>> retained_;  // 当前回调中已被接管的接收缓冲区
+  std::shared_ptr<HandlerMemory> handler_memory_;      // 完成处理函数内存池
+  // 生产者线程写入的无锁发送队列，节点经 asio 的线程级缓存回收复用
+  MpscQueue<std::string, asio::recycling_allocator<std::string>> send_queue_;
+  std::atomic<bool> doorbell_{false};           // 是否已投递 drain_send_queue
+  RingQueue<std::string> write_msgs_;           // 待发送消息队列
+  std::vector<std::string> writing_msgs_;       // 正在写出的消息
+  std::vector<asio::const_buffer> write_bufs_;  // 本次聚合写的缓冲区序列
+  std::uint64_t write_start_ns_ = 0;            // 本次聚合写发起时间
+  bool writing_ = false;                        // 是否有聚合写在途
+  std::size_t memory_bytes_ = 0;                // write_msgs_ 与 spill_tail_ 中的字节数
+
+  OfflinePolicy offline_;            // 离线缓冲策略
+  SpillSegment spill_;               // 溢出段
+  RingQueue<std::string> spill_tail_;  // 溢出段非空期间入队、排在段后的内存消息
+  bool spill_unavailable_ = false;   // 溢出段文件创建失败，之后不再尝试
+
+  SendQueueLimits limits_;                       // 发送队列限制
+  std::atomic<std::size_t> queued_bytes_{0};     // 队列字节数
+  std::atomic<std::size_t> queued_messages_{0};  // 队列消息数
+  std::atomic<bool> above_high_{false};          // 是否处于高水位之上
+  std::atomic<int> blocked_senders_{0};          // 因 Block 策略而等待的发送线程数
+  std::mutex block_mutex_;                       // Block 策略等待用
+  std::condition_variable block_cv_;
+
+  TcpClientMetrics metrics_;  // 连接指标
 
   std::atomic<Status> current_status_{Status::Disconnected};  // 当前状态
   std::atomic<bool> stopped_{true};                           // 是否已停止
-  int reconnect_delay_ = 1;                                   // 重连延迟（秒）
+  ReconnectPolicy reconnect_policy_;                          // 重连退避策略
+  std::chrono::milliseconds reconnect_delay_{0};              // 上一次重连延迟，0 表示尚未重连
 
   MessageCallback on_message_;  // 消息回调
+  MessageViewCallback on_message_view_;  // 零拷贝消息回调
   StatusCallback on_status_;    // 状态回调
+  FlushCallback on_flush_;      // 聚合写完成回调
+  WatermarkCallback on_watermark_;  // 水位回调
 };
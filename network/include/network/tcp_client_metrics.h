@@ -0,0 +1,121 @@
+/*
+  TcpClientMetrics: TcpClient 的无锁连接指标
+  - 计数器均为 relaxed 原子量，由 io 线程更新，任意线程可随时调用 snapshot() 抓取，不需要进入 io 线程
+  - 写完成延迟使用对数线性直方图（每个 2 的幂区间再线性分为 8 个桶，相对误差约 12.5%）
+------------------------------------------------------------------------------------------
+  auto m = client->metrics();  // 每秒抓取一次
+  std::cout << m.bytes_sent << " " << m.write_latency.percentile(0.99) << "ns\n";
+------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// LatencyHistogram: 对数线性延迟直方图（纳秒），record() 无锁
+class LatencyHistogram
+{
+ public:
+  static const unsigned kSubBits = 3;                      // 每个 2 的幂区间的线性子桶位数
+  static const unsigned kSubBuckets = 1u << kSubBits;      // 子桶数
+  static const unsigned kMaxExponent = 36;                 // 最大记录约 2^37ns（约 137s），更大的值计入最后一个桶
+  static const unsigned kBuckets = (kMaxExponent - kSubBits + 2) * kSubBuckets;
+
+  // 直方图快照
+  struct Snapshot
+  {
+    std::vector<std::uint64_t> counts;  // 各桶计数
+    std::uint64_t count = 0;            // 样本总数
+    std::uint64_t sum = 0;              // 样本总和（纳秒）
+    std::uint64_t max = 0;              // 最大值（纳秒）
+
+    // 返回分位数 q (0~1) 所在桶的上界（纳秒），无样本时返回 0
+    std::uint64_t percentile(double q) const;
+
+    // 平均值（纳秒）
+    double mean() const;
+  };
+
+  LatencyHistogram();
+
+  // 记录一个样本（纳秒）
+  void record(std::uint64_t ns);
+
+  // 抓取快照
+  Snapshot snapshot() const;
+
+  // 值所在的桶序号 / 桶的上界
+  static unsigned bucket_of(std::uint64_t ns);
+  static std::uint64_t bucket_upper(unsigned bucket);
+
+ private:
+  std::atomic<std::uint64_t> counts_[kBuckets];
+  std::atomic<std::uint64_t> sum_{0};
+  std::atomic<std::uint64_t> max_{0};
+};
+
+// TcpClientMetrics: 单个连接的计数器集合
+class TcpClientMetrics
+{
+ public:
+  // 指标快照
+  struct Snapshot
+  {
+    std::uint64_t bytes_sent = 0;          // 已写出字节数
+    std::uint64_t messages_sent = 0;       // 已写出消息数
+    std::uint64_t bytes_received = 0;      // 已接收字节数
+    std::uint64_t messages_received = 0;   // 已交付消息数（分帧时为帧数）
+    std::uint64_t write_queue_depth = 0;   // 当前发送队列消息数
+    std::uint64_t write_queue_peak = 0;    // 发送队列消息数峰值
+    std::uint64_t reconnects = 0;          // 重连尝试次数
+    std::uint64_t disconnected_ns = 0;     // 累计未连接时间（纳秒，含当前这段）
+    std::uint64_t spilled_messages = 0;    // 当前溢出段中待回放的消息数
+    std::uint64_t spilled_bytes = 0;       // 当前溢出段中待回放的字节数
+    std::uint64_t spill_full = 0;          // 因溢出段写满而留在内存中的消息数
+    std::uint64_t failovers = 0;           // 因往返延迟劣化而主动切换端点的次数
+    bool connected = false;                // 抓取时是否已连接
+    LatencyHistogram::Snapshot write_latency;  // 写完成延迟（从发起聚合写到完成）
+  };
+
+  TcpClientMetrics();
+
+  void on_sent(std::size_t messages, std::size_t bytes);
+  void on_received_bytes(std::size_t bytes);
+  void on_received_message();
+  void on_queue_depth(std::size_t depth);  // 发送队列深度变化（用于更新峰值）
+  void on_reconnect();
+  void on_connected();
+  void on_disconnected();
+  void on_write_latency(std::uint64_t ns);
+  void on_spilled(std::size_t bytes);                        // 一条消息写入溢出段
+  void on_replayed(std::size_t messages, std::size_t bytes);  // 溢出段中的消息已写出
+  void on_spill_full();
+  void on_failover();
+
+  // 单项计数的轻量读取
+  std::uint64_t bytes_sent() const;
+  std::uint64_t bytes_received() const;
+
+  // 抓取快照，write_queue_depth 由调用方填入
+  Snapshot snapshot() const;
+
+  // 单调时钟当前时间（纳秒）
+  static std::uint64_t now_ns();
+
+ private:
+  std::atomic<std::uint64_t> bytes_sent_{0};
+  std::atomic<std::uint64_t> messages_sent_{0};
+  std::atomic<std::uint64_t> bytes_received_{0};
+  std::atomic<std::uint64_t> messages_received_{0};
+  std::atomic<std::uint64_t> write_queue_peak_{0};
+  std::atomic<std::uint64_t> reconnects_{0};
+  std::atomic<std::uint64_t> disconnected_ns_{0};     // 已结束的未连接时间段之和
+  std::atomic<std::uint64_t> disconnected_since_{0};  // 当前未连接时间段起点，0 表示已连接
+  std::atomic<std::uint64_t> spilled_messages_{0};
+  std::atomic<std::uint64_t> spilled_bytes_{0};
+  std::atomic<std::uint64_t> spill_full_{0};
+  std::atomic<std::uint64_t> failovers_{0};
+  LatencyHistogram write_latency_;
+};
@@ -0,0 +1,98 @@
+/*
+  TcpClientPool: 同一服务器端点上的 N 个 TcpClient 连接池，提供与 TcpClient 相同的发送/回调接口
+  - 连接可分布在多个 io_context 上（例如每个线程一个 io_context），突破单连接单核的限制
+  - 发送分发策略: 轮询、最少排队字节、按 key 哈希（同一 key 固定到同一连接，保证该 key 内的消息顺序）
+  - 每个连接各自自动重连，连接池跟踪健康连接数，轮询/最少排队策略会跳过未连接的连接
+------------------------------------------------------------------------------------------
+  std::vector<asio::io_context*> contexts = {&io1, &io2};
+  TcpClientPool pool(contexts, "127.0.0.1", "8080", 4, TcpClientPool::DispatchPolicy::LeastQueuedBytes);
+  pool.set_message_callback([](const std::string& msg) { ... });  // 可能在不同 io 线程中并发调用
+  pool.set_health_callback([](std::size_t healthy, std::size_t total) { ... });
+  pool.start();
+  pool.send("hello");
+  pool.send("user-42", "ordered for user-42");  // 按 key 路由
+  pool.stop();
+------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+#include <asio.hpp>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "network/tcp_client.h"
+
+// TcpClientPool: 多连接客户端池
+class TcpClientPool
+{
+ public:
+  // 发送分发策略
+  enum class DispatchPolicy
+  {
+    RoundRobin,        // 轮询
+    LeastQueuedBytes,  // 选择发送队列字节数最少的连接
+    KeyHash            // 按 key 哈希选择连接；不带 key 的 send() 退化为轮询
+  };
+
+  using MessageCallback = TcpClient::MessageCallback;
+  // 状态回调(连接序号, 状态, 信息)
+  using StatusCallback = std::function<void(std::size_t, TcpClient::Status, const std::string&)>;
+  using HealthCallback = std::function<void(std::size_t, std::size_t)>;  // 健康连接数变化回调(健康数, 总数)
+  using CodecFactory = std::function<std::shared_ptr<FrameCodec>()>;     // 每个连接独立的分帧编解码器
+
+  // 所有连接共享一个 io_context
+  TcpClientPool(asio::io_context& io, const std::string& host, const std::string& port, std::size_t size,
+                DispatchPolicy policy = DispatchPolicy::RoundRobin);
+
+  // 连接按序号轮流分配到多个 io_context 上
+  TcpClientPool(const std::vector<asio::io_context*>& contexts, const std::string& host, const std::string& port,
+                std::size_t size, DispatchPolicy policy = DispatchPolicy::RoundRobin);
+
+  ~TcpClientPool();
+
+  TcpClientPool(const TcpClientPool&) = delete;
+  TcpClientPool& operator=(const TcpClientPool&) = delete;
+
+  // 以下回调与配置需在 start() 前设置
+  void set_message_callback(MessageCallback cb);
+  void set_status_callback(StatusCallback cb);
+  void set_health_callback(HealthCallback cb);
+  void set_frame_codec_factory(CodecFactory factory);
+  void set_send_queue_limits(const TcpClient::SendQueueLimits& limits);
+
+  // 启动/停止所有连接
+  void start();
+  void stop();
+
+  // 按分发策略选择连接发送（线程安全），被选中连接拒绝时返回 false
+  bool send(const std::string& msg);
+
+  // 按 key 哈希固定选择连接发送（线程安全），同一 key 的消息保持顺序
+  bool send(const std::string& key, const std::string& msg);
+
+  // 按分帧编解码器编码后发送
+  bool send_frame(const std::string& payload);
+
+  std::size_t size() const;                   // 连接总数
+  std::size_t healthy_count() const;          // 当前已连接的连接数
+  std::size_t queued_bytes() const;           // 所有连接排队字节数之和
+  std::shared_ptr<TcpClient> client(std::size_t index) const;  // 访问单个连接
+
+ private:
+  struct State;
+
+  // 创建连接
+  void init(const std::vector<asio::io_context*>& contexts, const std::string& host, const std::string& port,
+            std::size_t size);
+
+  // 按策略选出一个连接
+  std::size_t pick() const;
+
+  std::vector<std::shared_ptr<TcpClient>> clients_;
+  DispatchPolicy policy_;
+  mutable std::atomic<std::size_t> next_{0};  // 轮询游标
+  std::shared_ptr<State> state_;              // 与连接回调共享的状态，连接池析构后回调仍可安全访问
+};
@@ -0,0 +1,189 @@
+/*
+  TcpServer: 多核 TCP 服务器，每个工作线程一个 io_context
+  - 每个工作线程持有自己的接受器，均以 SO_REUSEPORT 绑定同一端口，由内核把新连接分散到各线程，
+    接受与读写都不跨线程；平台不支持 SO_REUSEPORT（或关闭 reuse_port）时退化为单个接受器轮流分配
+  - 会话从接受到关闭始终固定在一个线程上，所有回调都在该会话所属的工作线程中执行，会话内部不加锁
+  - Session::send() 可在任意线程调用，非所属线程调用时投递到所属线程执行
+  - 可选分帧编解码器（每个会话独立实例），未设置时消息回调收到每次读取到的原始数据
+------------------------------------------------------------------------------------------
+  TcpServer::Options options;
+  options.port = 8080;
+  options.workers = 4;
+  TcpServer server(options);
+  server.set_message_callback([](const TcpServer::SessionPtr& session, asio::const_buffer data) {
+    session->send(std::string(static_cast<const char*>(data.data()), data.size()));  // 回显
+  });
+  std::error_code ec;
+  if (!server.start(ec)) std::cerr << ec.message() << "\n";
+  ...
+  server.stop();
+------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+#include <asio.hpp>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "network/frame_codec.h"
+#include "network/handler_allocator.h"
+#include "network/receive_buffer.h"
+
+// TcpServer: 每线程一个 io_context 的多核 TCP 服务器
+class TcpServer
+{
+ public:
+  // 服务器选项
+  struct Options
+  {
+    std::string address = "0.0.0.0";  // 监听地址
+    unsigned short port = 0;          // 监听端口，0 表示由系统分配（所有接受器共用分配到的端口）
+    std::size_t workers = 0;          // 工作线程数，0 表示硬件线程数
+    bool reuse_port = true;           // 每个工作线程一个 SO_REUSEPORT 接受器
+    int backlog = asio::socket_base::max_listen_connections;  // 每个接受器的监听队列长度
+    bool no_delay = true;                                     // 对已接受的连接开启 TCP_NODELAY
+    std::size_t read_buffer_size = 16 * 1024;                 // 每个会话的初始接收缓冲区大小
+  };
+
+  class Session;
+  using SessionPtr = std::shared_ptr<Session>;
+  using ConnectionCallback = std::function<void(const SessionPtr&)>;                    // 新连接回调
+  // 收到消息（视图仅在回调期间有效）
+  using MessageCallback = std::function<void(const SessionPtr&, asio::const_buffer)>;
+  using CloseCallback = std::function<void(const SessionPtr&, const std::error_code&)>;  // 连接关闭回调
+  using CodecFactory = std::function<std::shared_ptr<FrameCodec>()>;                      // 每个会话独立的分帧编解码器
+
+  explicit TcpServer(const Options& options);
+  ~TcpServer();
+
+  TcpServer(const TcpServer&) = delete;
+  TcpServer& operator=(const TcpServer&) = delete;
+
+  // 以下回调与配置需在 start() 前设置，回调在会话所属的工作线程中执行
+  void set_connection_callback(ConnectionCallback cb);
+  void set_message_callback(MessageCallback cb);
+  void set_close_callback(CloseCallback cb);
+  void set_frame_codec_factory(CodecFactory factory);
+
+  // 绑定监听并启动工作线程，失败时设置 ec 并返回 false（不会启动任何线程）
+  bool start(std::error_code& ec);
+
+  // 关闭所有接受器和会话（触发关闭回调），等待工作线程退出；不能在工作线程中调用
+  void stop();
+
+  // 实际监听的端口（start() 成功后有效）
+  unsigned short port() const;
+
+  // 工作线程数，以及是否每个工作线程各有一个 SO_REUSEPORT 接受器
+  std::size_t workers() const;
+  bool reuse_port() const;
+
+  // 已接受的连接总数 / 当前连接数（线程安全）
+  std::uint64_t accepted() const;
+  std::size_t connections() const;
+
+ private:
+  struct Worker;
+
+  // 在工作线程上发起下一个异步接受
+  void start_accept(Worker& worker);
+
+  // 在目标工作线程上创建并登记会话
+  void add_session(Worker& worker, asio::ip::tcp::socket socket);
+
+  // 会话关闭后从所属工作线程的登记表中移除
+  void remove_session(std::size_t worker, std::uint64_t id);
+
+  Options options_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  unsigned short port_ = 0;
+  bool reuse_port_ = false;
+  std::size_t next_worker_ = 0;  // 单接受器模式下轮流分配的游标（只在 0 号线程访问）
+  std::atomic<std::uint64_t> accepted_{0};
+  std::atomic<std::size_t> connections_{0};
+
+  ConnectionCallback on_connection_;
+  MessageCallback on_message_;
+  CloseCallback on_close_;
+  CodecFactory codec_factory_;
+};
+
+// TcpServer::Session: 一个已接受的连接，固定在一个工作线程上
+// 会话对象可由使用者持有，但不能在 TcpServer 析构后继续使用
+class TcpServer::Session : public std::enable_shared_from_this<Session>
+{
+ public:
+  // 发送数据（线程安全），连接已关闭时静默丢弃
+  void send(const std::string& data);
+  void send(std::string&& data);
+
+  // 按分帧编解码器编码后发送一帧，未设置编解码器时等同于 send()
+  // 编解码器无法编码该帧（超长、含分隔符、不等于固定帧长等）时不发送并返回 false
+  bool send_frame(const std::string& payload);
+
+  // 关闭连接（线程安全）: 先写完已入队的数据再关闭，之后的 send() 被忽略，关闭回调只触发一次
+  // 对端不再读取时会一直等待写完成；TcpServer::stop() 则直接关闭，丢弃未写出的数据
+  void close();
+
+  // 会话 ID（服务器内唯一，非零）和所属工作线程序号
+  std::uint64_t id() const
+  {
+    return id_;
+  }
+
+  std::size_t worker() const
+  {
+    return worker_;
+  }
+
+  const asio::ip::tcp::endpoint& remote_endpoint() const
+  {
+    return remote_;
+  }
+
+  // 所属工作线程的 io_context，可用于在该线程上安排与会话相关的定时器等
+  asio::io_context& context()
+  {
+    return io_;
+  }
+
+ private:
+  friend class TcpServer;
+
+  Session(TcpServer& server, asio::io_context& io, std::size_t worker, std::uint64_t id,
+          asio::ip::tcp::socket socket);
+
+  void start();
+  void do_read();
+  bool dispatch_received();
+  void enqueue(std::string&& data);
+  void do_write();
+  void shutdown(const std::error_code& ec);
+
+  HandlerAllocator<void> handler_allocator() const
+  {
+    return HandlerAllocator<void>(handler_memory_);
+  }
+
+  TcpServer& server_;
+  asio::io_context& io_;
+  std::size_t worker_;
+  std::uint64_t id_;
+  asio::ip::tcp::socket socket_;
+  asio::ip::tcp::endpoint remote_;
+  std::shared_ptr<FrameCodec> codec_;
+  std::shared_ptr<HandlerMemory> handler_memory_;  // 完成处理函数内存池
+  ReceiveBuffer recv_buf_;                         // 接收缓冲区
+  std::deque<std::string> write_msgs_;             // 待发送消息
+  std::vector<std::string> writing_msgs_;          // 正在写出的消息
+  std::vector<asio::const_buffer> write_bufs_;     // 本次聚合写的缓冲区序列
+  bool writing_ = false;
+  bool closing_ = false;  // close() 已调用，写完队列后关闭
+  bool closed_ = false;
+};
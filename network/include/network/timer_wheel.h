@@ -0,0 +1,99 @@
+/*
+  TimerWheel: 挂在 io_context 上的分层时间轮服务，用一个 steady_timer 驱动任意多个逻辑定时器
+  - 4 层、每层 256 槽，刻度默认 10ms，可覆盖约 497 天
+  - arm()/cancel() 均为 O(1)：定时器节点嵌入使用者对象，以侵入式双向链表挂在槽上，不分配内存
+  - 只有存在已启动的定时器时底层 steady_timer 才会运行
+  - 每个 io_context 一个实例，线程安全（io_context 可在多个线程上运行）
+------------------------------------------------------------------------------------------
+  TimerWheel& wheel = TimerWheel::get(io);
+  TimerWheel::Timer heartbeat;  // 通常作为成员嵌入在连接对象中
+  wheel.arm(heartbeat, std::chrono::seconds(5), [] { ... });  // 回调在 io 线程中执行
+  wheel.cancel(heartbeat);
+------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+#include <asio.hpp>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+// TimerWheel: 分层时间轮服务
+class TimerWheel : public asio::io_context::service
+{
+ public:
+  using Clock = std::chrono::steady_clock;
+  using Callback = std::function<void()>;
+
+  // 定时器节点，嵌入到使用者对象中；析构时自动取消，不可复制
+  class Timer
+  {
+   public:
+    Timer() = default;
+    ~Timer();
+    Timer(const Timer&) = delete;
+    Timer& operator=(const Timer&) = delete;
+
+    // 是否已启动且尚未到期
+    bool armed() const;
+
+   private:
+    friend class TimerWheel;
+    Timer* prev_ = nullptr;
+    Timer* next_ = nullptr;
+    std::uint64_t expiry_ = 0;         // 到期刻度
+    TimerWheel* wheel_ = nullptr;      // 所在的时间轮，未启动时为 nullptr
+    Callback callback_;
+  };
+
+  static asio::io_context::id id;
+
+  explicit TimerWheel(asio::io_context& io);
+  ~TimerWheel();
+
+  // 获取 io_context 上的时间轮实例
+  static TimerWheel& get(asio::io_context& io);
+
+  // 启动定时器，delay 后在 io 线程中调用 callback；已启动的定时器会先被取消
+  void arm(Timer& timer, Clock::duration delay, Callback callback);
+
+  // 取消定时器，未启动时无操作
+  void cancel(Timer& timer);
+
+  // 刻度精度
+  static Clock::duration resolution();
+
+  // 当前已启动的定时器数
+  std::size_t size() const;
+
+ private:
+  static const unsigned kLevels = 4;
+  static const unsigned kSlotBits = 8;
+  static const unsigned kSlots = 1u << kSlotBits;
+
+  struct Slot
+  {
+    Timer* head = nullptr;
+  };
+
+  void shutdown() override;
+
+  // 以下均需持有 mutex_
+  void link(Timer& timer);
+  void unlink(Timer& timer);
+  void cascade(unsigned level);
+  std::uint64_t tick_of(Clock::time_point t) const;
+  void start_driver();
+
+  // 底层 steady_timer 到期
+  void on_tick();
+
+  mutable std::mutex mutex_;
+  asio::steady_timer driver_;
+  bool driver_running_ = false;
+  Clock::time_point epoch_;      // 刻度 0 对应的时间
+  std::uint64_t current_ = 0;    // 已推进到的刻度
+  std::size_t count_ = 0;        // 已启动的定时器数
+  Slot wheel_[kLevels][kSlots];  // 各层的槽
+};
@@ -0,0 +1,150 @@
+/*
+  UdpBatchSocket: 基于 recvmmsg / sendmmsg 的批量 UDP 收发
+  - 套接字可读时，一次 recvmmsg 最多取出 batch_size 个数据报，收进预分配的消息数组（不做任何堆分配），
+    整批以数组视图交给接收回调；一批取满时投递下一轮继续取，取空后再等待可读
+  - 回调中调用 send_to() 只把回复拷贝进预分配的发送区，回调返回后用一次 sendmmsg 整批发出；
+    发送区满时先发出已排队的数据报，内核发送缓冲区满（EAGAIN）时等待可写后继续发送，期间发送区仍满则丢弃
+  - 500k pps 的请求-应答负载由每个数据报两次系统调用降为每批两次
+  - 大批量数据可使用 UDP 分段卸载（Linux）: send_segments() 把一个大缓冲区作为一条消息交给内核（UDP_SEGMENT），
+    由协议栈按 segment_size 切成多个数据报；开启 gro 后内核把同一来源的连续数据报合并成一个超级数据报交上来（UDP_GRO），
+    Datagram::segment_size 给出其中每个数据报的长度。回环接口同样支持；内核不支持时自动退化为逐个数据报收发
+  - 非 Linux 平台退化为逐个非阻塞 receive_from / send_to，接口与行为保持一致
+  - 非线程安全: 所有调用都必须在运行 io_context 的同一个线程上进行；
+    析构前需先 stop() 并让 io_context 处理完已取消的等待操作
+------------------------------------------------------------------------------------------
+  asio::io_context io(1);
+  UdpBatchSocket socket(io, asio::ip::udp::endpoint(asio::ip::udp::v4(), 9000));
+  socket.start([&socket](const UdpBatchSocket::Datagram* datagrams, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) socket.send_to(datagrams[i].data, datagrams[i].remote);  // 回显
+  });
+  io.run();
+------------------------------------------------------------------------------------------
+*/
+
+#pragma once
+#include <asio.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <system_error>
+#include <vector>
+
+class UdpBatchSocket
+{
+ public:
+  // 批量收发选项
+  struct Options
+  {
+    std::size_t batch_size = 64;           // 每次系统调用最多收 / 发的数据报数
+    std::size_t max_datagram_size = 2048;  // 单个数据报的最大长度: 接收时超出部分被截断，发送时超出则丢弃
+    bool gro = false;  // 接收合并后的超级数据报（UDP_GRO），此时 max_datagram_size 应为 65535 以免截断
+  };
+
+  // 收到的一个数据报（视图，仅在接收回调期间有效）
+  struct Datagram
+  {
+    asio::const_buffer data;
+    asio::ip::udp::endpoint remote;
+    std::size_t segment_size = 0;  // 合并前每个数据报的长度（最后一个可能更短），未合并时等于 data.size()
+    bool truncated = false;        // 数据报长度超过 max_datagram_size
+  };
+
+  // 收发统计
+  struct Stats
+  {
+    std::uint64_t receive_calls = 0;  // 接收系统调用次数（包括返回 EAGAIN 的调用）
+    std::uint64_t received = 0;       // 收到的数据报数（合并的超级数据报按其中的数据报数计）
+    std::uint64_t send_calls = 0;     // 发送系统调用次数
+    std::uint64_t sent = 0;           // 发出的数据报数（分段发送按切分后的数据报数计）
+    std::uint64_t dropped = 0;        // 发送区满或发送出错而丢弃的数据报数
+  };
+
+  // 一批数据报的接收回调
+  using ReceiveHandler = std::function<void(const Datagram* datagrams, std::size_t count)>;
+
+  // 构造函数，打开并绑定到 local
+  UdpBatchSocket(asio::io_context& io, const asio::ip::udp::endpoint& local);
+  UdpBatchSocket(asio::io_context& io, const asio::ip::udp::endpoint& local, const Options& options);
+  ~UdpBatchSocket();
+
+  UdpBatchSocket(const UdpBatchSocket&) = delete;
+  UdpBatchSocket& operator=(const UdpBatchSocket&) = delete;
+
+  // 开始批量接收，每批数据报交给 handler，handler 返回后发出其间排队的回复
+  void start(ReceiveHandler handler);
+
+  // 停止接收并关闭套接字，未发出的数据报被丢弃
+  void stop();
+
+  // 排队一个待发送的数据报（拷贝 data），发送区满且无法立即发出时丢弃并返回 false
+  bool send_to(asio::const_buffer data, const asio::ip::udp::endpoint& remote);
+
+  // 排队一个大缓冲区，按 segment_size 切分成多个数据报发给同一目标（拷贝 data）
+  // 支持 UDP_SEGMENT 时每次最多 64 段、不超过 max_datagram_size 的部分作为一条消息由内核切分，否则逐段排队；
+  // 发送区放不下的部分被丢弃并返回 false
+  bool send_segments(asio::const_buffer data, std::size_t segment_size, const asio::ip::udp::endpoint& remote);
+
+  // 立即发出已排队的数据报，内核发送缓冲区满时剩余部分等待可写后自动发出；返回本次发出的数据报数
+  std::size_t flush();
+
+  // 已排队尚未发出的数据报数
+  std::size_t pending() const
+  {
+    return send_count_ - send_done_;
+  }
+
+  asio::ip::udp::socket& socket()
+  {
+    return socket_;
+  }
+
+  const Options& options() const
+  {
+    return options_;
+  }
+
+  const Stats& stats() const
+  {
+    return stats_;
+  }
+
+  // 内核是否支持发送分段卸载（UDP_SEGMENT）/ 接收合并是否已开启（UDP_GRO）
+  bool gso() const
+  {
+    return gso_;
+  }
+
+  bool gro() const
+  {
+    return gro_;
+  }
+
+ private:
+  struct Native;  // 平台相关的消息数组（mmsghdr / iovec / 控制消息）
+
+  bool enqueue(asio::const_buffer data, std::size_t segment_size, const asio::ip::udp::endpoint& remote);
+
+  void wait_readable();
+  void receive_batch();
+  std::size_t receive_some();
+  void wait_writable();
+
+  asio::ip::udp::socket socket_;
+  Options options_;
+  ReceiveHandler handler_;
+  std::unique_ptr<Native> native_;
+  std::vector<char> recv_buf_;          // batch_size 个接收槽
+  std::vector<Datagram> datagrams_;     // 本批收到的数据报视图
+  std::vector<char> send_buf_;          // batch_size 个发送槽
+  std::vector<std::size_t> send_size_;  // 每个发送槽中数据报的长度
+  std::vector<std::size_t> send_seg_;   // 每个发送槽的分段长度，0 表示不分段
+  std::vector<asio::ip::udp::endpoint> send_to_;
+  std::size_t send_count_ = 0;  // 发送区中已排队的数据报数
+  std::size_t send_done_ = 0;   // 其中已发出的数据报数
+  bool gso_ = false;
+  bool gro_ = false;
+  bool waiting_write_ = false;
+  bool stopped_ = false;
+  Stats stats_;
+};
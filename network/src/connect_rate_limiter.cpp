@@ -0,0 +1,116 @@
+#include "network/connect_rate_limiter.h"
+
+#include <algorithm>
+#include <vector>
+
+asio::io_context::id ConnectRateLimiter::id;
+
+ConnectRateLimiter::ConnectRateLimiter(asio::io_context& io) :
+  asio::io_context::service(io), wheel_(TimerWheel::get(io)), last_refill_(Clock::now())
+{
+}
+
+ConnectRateLimiter& ConnectRateLimiter::get(asio::io_context& io)
+{
+  return asio::use_service<ConnectRateLimiter>(io);
+}
+
+void ConnectRateLimiter::configure(double rate, std::size_t burst)
+{
+  std::deque<Callback> released;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    rate_ = rate > 0 ? rate : 0;
+    burst_ = static_cast<double>(std::max<std::size_t>(burst, 1));
+    tokens_ = burst_;
+    last_refill_ = Clock::now();
+    if (rate_ == 0)
+    {
+      released.swap(waiters_);
+    }
+    else
+    {
+      schedule();
+    }
+  }
+  for (auto& cb : released) cb();
+}
+
+void ConnectRateLimiter::acquire(Callback ready)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (rate_ > 0)
+    {
+      refill(Clock::now());
+      if (!waiters_.empty() || tokens_ < 1)
+      {
+        waiters_.push_back(std::move(ready));
+        schedule();
+        return;
+      }
+      tokens_ -= 1;
+    }
+  }
+  ready();
+}
+
+std::size_t ConnectRateLimiter::waiting() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return waiters_.size();
+}
+
+void ConnectRateLimiter::shutdown()
+{
+  std::deque<Callback> dropped;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    dropped.swap(waiters_);
+  }
+  wheel_.cancel(timer_);
+}
+
+void ConnectRateLimiter::refill(Clock::time_point now)
+{
+  double elapsed = std::chrono::duration<double>(now - last_refill_).count();
+  tokens_ = std::min(burst_, tokens_ + elapsed * rate_);
+  last_refill_ = now;
+}
+
+void ConnectRateLimiter::schedule()
+{
+  if (waiters_.empty() || timer_pending_) return;
+  timer_pending_ = true;
+  // 等到至少攒够一个令牌
+  double seconds = tokens_ >= 1 ? 0 : (1 - tokens_) / rate_;
+  wheel_.arm(timer_, std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds)),
+             [this] { on_timer(); });
+}
+
+void ConnectRateLimiter::on_timer()
+{
+  std::vector<Callback> ready;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    timer_pending_ = false;
+    refill(Clock::now());
+    while (!waiters_.empty() && tokens_ >= 1)
+    {
+      tokens_ -= 1;
+      ready.push_back(std::move(waiters_.front()));
+      waiters_.pop_front();
+    }
+    schedule();
+  }
+  for (auto& cb : ready)
+  {
+    try
+    {
+      cb();
+    }
+    catch (...)
+    {
+    }
+  }
+}
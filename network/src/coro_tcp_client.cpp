@@ -0,0 +1,118 @@
+#include "network/coro_tcp_client.h"
+
+#if defined(ASIO_HAS_CO_AWAIT)
+
+#include <system_error>
+
+using asio::ip::tcp;
+
+CoroTcpClient::CoroTcpClient(asio::io_context& io, std::string host, std::string port,
+                             const TcpClient::Options& options) :
+  io_(io),
+  socket_(io),
+  host_(std::move(host)),
+  port_(std::move(port)),
+  options_(options),
+  dns_cache_(DnsCache::shared())
+{
+}
+
+void CoroTcpClient::set_frame_codec(std::shared_ptr<FrameCodec> codec)
+{
+  codec_ = std::move(codec);
+}
+
+void CoroTcpClient::set_dns_cache(std::shared_ptr<DnsCache> cache)
+{
+  dns_cache_ = cache ? std::move(cache) : DnsCache::shared();
+}
+
+asio::awaitable<void> CoroTcpClient::connect()
+{
+  close();
+
+  // DnsCache 的回调是可复制的 std::function，而协程的完成处理器只能移动，因此放入 shared_ptr
+  using ResolveSignature = void(std::error_code, DnsCache::Results);
+  auto endpoints = co_await asio::async_initiate<decltype(asio::use_awaitable), ResolveSignature>(
+    [this](auto handler) {
+      auto h = std::make_shared<decltype(handler)>(std::move(handler));
+      dns_cache_->async_resolve(io_, host_, port_,
+                                [h](std::error_code ec, DnsCache::Results results) { (*h)(ec, results); });
+    },
+    asio::use_awaitable);
+
+  socket_ = tcp::socket(io_);
+  co_await asio::async_connect(socket_, endpoints, asio::use_awaitable);
+  TcpClient::apply_socket_options(socket_, options_);
+  recv_buf_.clear();
+  if (codec_) codec_->reset();
+}
+
+asio::awaitable<void> CoroTcpClient::send(asio::const_buffer buf)
+{
+  co_await asio::async_write(socket_, buf, asio::use_awaitable);
+}
+
+asio::awaitable<void> CoroTcpClient::send_frame(std::string_view payload)
+{
+  if (!codec_)
+  {
+    co_await send(asio::buffer(payload));
+    co_return;
+  }
+  send_buf_.clear();
+  if (!codec_->encode(payload.data(), payload.size(), send_buf_))
+    throw std::system_error(std::make_error_code(std::errc::message_size), "CoroTcpClient: frame cannot be encoded");
+  co_await asio::async_write(socket_, asio::buffer(send_buf_), asio::use_awaitable);
+}
+
+asio::awaitable<std::string_view> CoroTcpClient::receive_frame()
+{
+  for (;;)
+  {
+    if (codec_ && !recv_buf_.empty())
+    {
+      const char* frame = nullptr;
+      std::size_t frame_size = 0;
+      std::error_code ec;
+      std::size_t consumed = codec_->decode(recv_buf_.data(), recv_buf_.size(), frame, frame_size, ec);
+      if (ec) throw std::system_error(ec, "CoroTcpClient: invalid frame");
+      if (consumed)
+      {
+        recv_buf_.consume(consumed);
+        co_return std::string_view(frame, frame_size);
+      }
+    }
+
+    recv_buf_.commit(co_await socket_.async_read_some(recv_buf_.prepare(), asio::use_awaitable));
+
+    if (!codec_)
+    {
+      std::string_view chunk(recv_buf_.data(), recv_buf_.size());
+      recv_buf_.consume(chunk.size());
+      co_return chunk;
+    }
+  }
+}
+
+bool CoroTcpClient::is_open() const
+{
+  return socket_.is_open();
+}
+
+void CoroTcpClient::close()
+{
+  std::error_code ec;
+  if (socket_.is_open())
+  {
+    socket_.shutdown(tcp::socket::shutdown_both, ec);
+    socket_.close(ec);
+  }
+}
+
+tcp::socket& CoroTcpClient::socket()
+{
+  return socket_;
+}
+
+#endif  // defined(ASIO_HAS_CO_AWAIT)
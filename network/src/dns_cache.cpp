@@ -0,0 +1,180 @@
+#include "network/dns_cache.h"
+
+#include <algorithm>
+#include <atomic>
+
+using asio::ip::tcp;
+
+namespace
+{
+// 单次解析的时限: getaddrinfo 自身的超时重试通常在此之内结束，超过时视为解析已丢失
+const std::chrono::seconds kResolveTimeout(30);
+// 条目数清理阈值的下限
+const std::size_t kMinSweepEntries = 64;
+}  // namespace
+
+// 持有者全部销毁时若还未被调用，说明解析函数丢弃了回调（例如解析器所在的 io_context 已销毁）
+class DnsCache::Completion
+{
+ public:
+  Completion(std::shared_ptr<DnsCache> cache, Key key, std::uint64_t generation) :
+    cache_(std::move(cache)), key_(std::move(key)), generation_(generation)
+  {
+  }
+
+  ~Completion()
+  {
+    if (!called_.load()) cache_->complete(key_, generation_, asio::error::operation_aborted, Results());
+  }
+
+  void operator()(std::error_code ec, Results results)
+  {
+    if (!called_.exchange(true)) cache_->complete(key_, generation_, ec, results);
+  }
+
+ private:
+  std::shared_ptr<DnsCache> cache_;
+  Key key_;
+  std::uint64_t generation_;
+  std::atomic<bool> called_{false};
+};
+
+DnsCache::DnsCache(std::chrono::steady_clock::duration ttl, std::chrono::steady_clock::duration negative_ttl) :
+  sweep_at_(kMinSweepEntries), resolve_fn_(&DnsCache::default_resolve), ttl_(ttl), negative_ttl_(negative_ttl)
+{
+}
+
+std::shared_ptr<DnsCache> DnsCache::shared()
+{
+  static std::shared_ptr<DnsCache> instance = std::make_shared<DnsCache>();
+  return instance;
+}
+
+void DnsCache::async_resolve(asio::io_context& io, const std::string& host, const std::string& port,
+                             Handler handler)
+{
+  async_resolve(io, io.get_executor(), host, port, std::move(handler));
+}
+
+void DnsCache::async_resolve(asio::io_context& io, const asio::any_io_executor& executor, const std::string& host,
+                             const std::string& port, Handler handler)
+{
+  Key key(host, port);
+  ResolveFunction fn;
+  std::uint64_t generation = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Clock::time_point now = Clock::now();
+    auto it = entries_.find(key);
+    if (it == entries_.end())
+    {
+      if (entries_.size() >= sweep_at_) sweep_expired(now);
+      it = entries_.emplace(key, Entry()).first;
+    }
+    Entry& entry = it->second;
+    if (entry.resolving && now < entry.resolve_deadline)
+    {
+      // 已有相同的解析在进行，挂起等待
+      entry.waiters.push_back(Waiter{executor, std::move(handler)});
+      return;
+    }
+    if (!entry.resolving && entry.expires > now)
+    {
+      // 命中缓存（成功或失败）
+      std::error_code ec = entry.ec;
+      Results results = entry.results;
+      asio::post(executor, [handler, ec, results] { handler(ec, results); });
+      return;
+    }
+    // 没有解析在进行，或进行中的解析已超时（其 io_context 停止后不再运行）: 发起新的解析，已有的等待者一并等待它
+    entry.resolving = true;
+    entry.resolve_deadline = now + kResolveTimeout;
+    generation = ++entry.generation;
+    entry.waiters.push_back(Waiter{executor, std::move(handler)});
+    fn = resolve_fn_;
+  }
+
+  // 在锁外发起解析，避免解析函数同步回调时死锁
+  auto completion = std::make_shared<Completion>(shared_from_this(), key, generation);
+  fn(io, host, port, [completion](std::error_code ec, Results results) { (*completion)(ec, results); });
+}
+
+void DnsCache::set_resolve_function(ResolveFunction fn)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  resolve_fn_ = fn ? std::move(fn) : ResolveFunction(&DnsCache::default_resolve);
+}
+
+void DnsCache::invalidate(const std::string& host, const std::string& port)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(Key(host, port));
+  if (it != entries_.end() && !it->second.resolving) entries_.erase(it);
+}
+
+void DnsCache::clear()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto it = entries_.begin(); it != entries_.end();)
+  {
+    if (it->second.resolving)
+    {
+      ++it;
+    }
+    else
+    {
+      it = entries_.erase(it);
+    }
+  }
+}
+
+void DnsCache::complete(const Key& key, std::uint64_t generation, std::error_code ec, Results results)
+{
+  std::vector<Waiter> waiters;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    // 超时后已被新的解析取代
+    if (it == entries_.end() || !it->second.resolving || it->second.generation != generation) return;
+    Entry& entry = it->second;
+    entry.ec = ec;
+    entry.results = ec ? Results() : results;
+    // 被取消的解析（例如解析器所在的 io_context 停止）不代表域名不存在，不做负缓存，下次请求重新解析
+    if (ec == asio::error::operation_aborted)
+      entry.expires = Clock::time_point();
+    else
+      entry.expires = Clock::now() + (ec ? negative_ttl_ : ttl_);
+    entry.resolving = false;
+    waiters.swap(entry.waiters);
+  }
+
+  for (auto& w : waiters)
+  {
+    Handler handler = std::move(w.handler);
+    asio::post(w.executor, [handler, ec, results] { handler(ec, results); });
+  }
+}
+
+void DnsCache::sweep_expired(Clock::time_point now)
+{
+  for (auto it = entries_.begin(); it != entries_.end();)
+  {
+    if (!it->second.resolving && it->second.expires <= now)
+    {
+      it = entries_.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+  sweep_at_ = std::max(kMinSweepEntries, entries_.size() * 2);
+}
+
+void DnsCache::default_resolve(asio::io_context& io, const std::string& host, const std::string& port,
+                               Handler handler)
+{
+  auto resolver = std::make_shared<tcp::resolver>(io);
+  resolver->async_resolve(host, port,
+                          [resolver, handler](std::error_code ec, Results results) { handler(ec, results); });
+}
@@ -0,0 +1,107 @@
+#include "network/endpoint_selector.h"
+
+void EndpointSelector::set_endpoints(const std::vector<Endpoint>& endpoints)
+{
+  if (endpoints.empty()) return;
+  std::lock_guard<std::mutex> lock(mutex_);
+  endpoints_.clear();
+  for (const auto& ep : endpoints) endpoints_.push_back(State(ep));
+  current_ = 0;
+}
+
+void EndpointSelector::set_policy(const FailoverPolicy& policy)
+{
+  policy_ = policy;
+}
+
+bool EndpointSelector::empty() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return endpoints_.empty();
+}
+
+EndpointSelector::Endpoint EndpointSelector::select()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  Clock::time_point now = Clock::now();
+  // 连续失败次数少者优先，其次 srtt 小者优先；尚无样本的端点 srtt 视为 0，相同时保持列表顺序
+  std::size_t best = 0;
+  for (std::size_t i = 1; i < endpoints_.size(); ++i)
+  {
+    std::uint32_t a = failures(endpoints_[i], now);
+    std::uint32_t b = failures(endpoints_[best], now);
+    if (a != b)
+    {
+      if (a < b) best = i;
+    }
+    else if (endpoints_[i].srtt_us < endpoints_[best].srtt_us)
+    {
+      best = i;
+    }
+  }
+  current_ = best;
+  return endpoints_[current_].endpoint;
+}
+
+void EndpointSelector::on_connected()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!endpoints_.empty()) endpoints_[current_].failures = 0;
+}
+
+void EndpointSelector::on_failure()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (endpoints_.empty()) return;
+  State& current = endpoints_[current_];
+  Clock::time_point now = Clock::now();
+  // 冷却期已过的旧失败不再累计
+  current.failures = failures(current, now) + 1;
+  current.last_failure = now;
+}
+
+bool EndpointSelector::on_rtt_sample(double rtt_us, double& srtt_us)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (endpoints_.empty()) return false;
+  State& current = endpoints_[current_];
+  current.srtt_us = current.samples == 0 ? rtt_us : current.srtt_us + policy_.rtt_gain * (rtt_us - current.srtt_us);
+  ++current.samples;
+  srtt_us = current.srtt_us;
+  if (policy_.rtt_threshold.count() <= 0 || srtt_us <= policy_.rtt_threshold.count() * 1000.0) return false;
+
+  // 只有存在明显更优（或尚未测过）的健康端点时才切换，避免在同样慢的端点之间来回跳
+  Clock::time_point now = Clock::now();
+  for (std::size_t i = 0; i < endpoints_.size(); ++i)
+  {
+    const State& other = endpoints_[i];
+    if (i == current_ || failures(other, now) > 0) continue;
+    if (other.samples == 0 || other.srtt_us * policy_.switch_ratio < srtt_us) return true;
+  }
+  return false;
+}
+
+std::vector<EndpointSelector::EndpointStats> EndpointSelector::stats() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  Clock::time_point now = Clock::now();
+  std::vector<EndpointStats> stats;
+  for (std::size_t i = 0; i < endpoints_.size(); ++i)
+  {
+    EndpointStats st;
+    st.endpoint = endpoints_[i].endpoint;
+    st.srtt = std::chrono::microseconds(static_cast<std::int64_t>(endpoints_[i].srtt_us));
+    st.samples = endpoints_[i].samples;
+    st.failures = failures(endpoints_[i], now);
+    st.current = i == current_;
+    stats.push_back(st);
+  }
+  return stats;
+}
+
+std::uint32_t EndpointSelector::failures(const State& state, Clock::time_point now) const
+{
+  bool cooled = policy_.failure_cooldown.count() > 0 && now - state.last_failure >= policy_.failure_cooldown;
+  if (state.failures > 0 && cooled) return 0;
+  return state.failures;
+}
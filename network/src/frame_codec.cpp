@@ -0,0 +1,167 @@
+#include "network/frame_codec.h"
+
+#include <algorithm>
+
+LengthPrefixCodec::LengthPrefixCodec(Prefix prefix, std::size_t max_frame_size) :
+  prefix_(prefix), max_frame_size_(max_frame_size)
+{
+}
+
+std::size_t LengthPrefixCodec::decode(const char* data, std::size_t size, const char*& frame,
+                                      std::size_t& frame_size, std::error_code& ec)
+{
+  const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+  std::uint64_t length = 0;
+  std::size_t header = 0;
+
+  switch (prefix_)
+  {
+    case Prefix::Varint:
+    {
+      unsigned shift = 0;
+      for (;;)
+      {
+        if (header == size) return 0;
+        if (header == 10)  // 超过 64 位
+        {
+          ec = std::make_error_code(std::errc::bad_message);
+          return 0;
+        }
+        unsigned char byte = p[header++];
+        if (shift == 63 && (byte & 0x7f) > 1)  // 第 10 个字节只能携带最高位
+        {
+          ec = std::make_error_code(std::errc::bad_message);
+          return 0;
+        }
+        length |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) break;
+        shift += 7;
+      }
+      break;
+    }
+    case Prefix::U16:
+      if (size < 2) return 0;
+      length = (static_cast<std::uint64_t>(p[0]) << 8) | p[1];
+      header = 2;
+      break;
+    case Prefix::U32:
+      if (size < 4) return 0;
+      length = (static_cast<std::uint64_t>(p[0]) << 24) | (static_cast<std::uint64_t>(p[1]) << 16) |
+               (static_cast<std::uint64_t>(p[2]) << 8) | p[3];
+      header = 4;
+      break;
+  }
+
+  if (length > max_frame_size_)
+  {
+    ec = std::make_error_code(std::errc::message_size);
+    return 0;
+  }
+  if (size - header < length) return 0;
+
+  frame = data + header;
+  frame_size = static_cast<std::size_t>(length);
+  return header + frame_size;
+}
+
+bool LengthPrefixCodec::encode(const char* data, std::size_t size, std::string& out) const
+{
+  // 超过前缀能表示的长度时截断会让对端错位，直接拒绝
+  std::uint64_t limit = max_frame_size_;
+  if (prefix_ == Prefix::U16)
+    limit = std::min<std::uint64_t>(limit, 0xffff);
+  else if (prefix_ == Prefix::U32)
+    limit = std::min<std::uint64_t>(limit, 0xffffffff);
+  if (size > limit) return false;
+
+  switch (prefix_)
+  {
+    case Prefix::Varint:
+    {
+      std::uint64_t v = size;
+      do
+      {
+        unsigned char byte = static_cast<unsigned char>(v & 0x7f);
+        v >>= 7;
+        if (v) byte |= 0x80;
+        out.push_back(static_cast<char>(byte));
+      } while (v);
+      break;
+    }
+    case Prefix::U16:
+      out.push_back(static_cast<char>((size >> 8) & 0xff));
+      out.push_back(static_cast<char>(size & 0xff));
+      break;
+    case Prefix::U32:
+      out.push_back(static_cast<char>((size >> 24) & 0xff));
+      out.push_back(static_cast<char>((size >> 16) & 0xff));
+      out.push_back(static_cast<char>((size >> 8) & 0xff));
+      out.push_back(static_cast<char>(size & 0xff));
+      break;
+  }
+  out.append(data, size);
+  return true;
+}
+
+DelimiterCodec::DelimiterCodec(std::string delimiter, std::size_t max_frame_size) :
+  delimiter_(delimiter.empty() ? std::string("\n") : std::move(delimiter)), max_frame_size_(max_frame_size)
+{
+}
+
+std::size_t DelimiterCodec::decode(const char* data, std::size_t size, const char*& frame, std::size_t& frame_size,
+                                   std::error_code& ec)
+{
+  // 从上次扫描结束处继续，回退 delimiter 长度 - 1 以覆盖跨两次到达的分隔符
+  std::size_t start = scanned_ >= delimiter_.size() ? scanned_ - (delimiter_.size() - 1) : 0;
+  const char* end = data + size;
+  const char* pos = std::search(data + start, end, delimiter_.begin(), delimiter_.end());
+  if (pos == end)
+  {
+    scanned_ = size;
+    if (size > max_frame_size_ + delimiter_.size()) ec = std::make_error_code(std::errc::message_size);
+    return 0;
+  }
+
+  scanned_ = 0;
+  frame = data;
+  frame_size = static_cast<std::size_t>(pos - data);
+  if (frame_size > max_frame_size_)
+  {
+    ec = std::make_error_code(std::errc::message_size);
+    return 0;
+  }
+  return frame_size + delimiter_.size();
+}
+
+bool DelimiterCodec::encode(const char* data, std::size_t size, std::string& out) const
+{
+  if (size > max_frame_size_) return false;
+  if (std::search(data, data + size, delimiter_.begin(), delimiter_.end()) != data + size) return false;
+  out.append(data, size);
+  out.append(delimiter_);
+  return true;
+}
+
+void DelimiterCodec::reset()
+{
+  scanned_ = 0;
+}
+
+FixedSizeCodec::FixedSizeCodec(std::size_t frame_size) : frame_size_(frame_size == 0 ? 1 : frame_size) {}
+
+std::size_t FixedSizeCodec::decode(const char* data, std::size_t size, const char*& frame, std::size_t& frame_size,
+                                   std::error_code& /*ec*/)
+{
+  if (size < frame_size_) return 0;
+  frame = data;
+  frame_size = frame_size_;
+  return frame_size_;
+}
+
+bool FixedSizeCodec::encode(const char* data, std::size_t size, std::string& out) const
+{
+  // 补齐或拆分后对端无法区分消息边界，只接受恰好一帧
+  if (size != frame_size_) return false;
+  out.append(data, size);
+  return true;
+}
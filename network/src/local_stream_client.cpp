@@ -0,0 +1,16 @@
+#include "network/local_stream_client.h"
+
+#if defined(ASIO_HAS_LOCAL_SOCKETS)
+
+LocalStreamClient::LocalStreamClient(asio::io_context& io, const std::string& path) :
+  LocalStreamClient(io, path, Options())
+{
+}
+
+LocalStreamClient::LocalStreamClient(asio::io_context& io, const std::string& path, const Options& options) :
+  TcpClient(io, asio::local::stream_protocol::endpoint(path), options),
+  path_(path)
+{
+}
+
+#endif  // defined(ASIO_HAS_LOCAL_SOCKETS)
@@ -0,0 +1,41 @@
+#include "network/receive_buffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+const std::size_t kMinSpace = 1024;  // 每次读取前保证的最小空闲空间
+}  // namespace
+
+ReceiveBuffer::ReceiveBuffer(std::size_t initial_size) : buf_(std::max(initial_size, kMinSpace)) {}
+
+asio::mutable_buffer ReceiveBuffer::prepare()
+{
+  if (buf_.size() - end_ < kMinSpace)
+  {
+    if (begin_ > 0)
+    {
+      // 把未完成的帧移动到缓冲区开头
+      std::memmove(buf_.data(), buf_.data() + begin_, end_ - begin_);
+      end_ -= begin_;
+      begin_ = 0;
+    }
+    if (buf_.size() - end_ < kMinSpace) buf_.resize(std::max(buf_.size() * 2, end_ + kMinSpace));
+  }
+  return asio::buffer(buf_.data() + end_, buf_.size() - end_);
+}
+
+void ReceiveBuffer::consume(std::size_t n)
+{
+  begin_ += std::min(n, end_ - begin_);
+  if (begin_ == end_) begin_ = end_ = 0;
+}
+
+std::vector<char> ReceiveBuffer::detach()
+{
+  std::vector<char> fresh(buf_.size());
+  std::memcpy(fresh.data() + begin_, buf_.data() + begin_, end_ - begin_);
+  buf_.swap(fresh);
+  return fresh;
+}
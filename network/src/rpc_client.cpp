@@ -0,0 +1,205 @@
+#include "network/rpc_client.h"
+
+namespace
+{
+const std::size_t kIdSize = 8;
+
+void put_u64(std::string& out, std::uint64_t v)
+{
+  for (int shift = 56; shift >= 0; shift -= 8) out.push_back(static_cast<char>((v >> shift) & 0xff));
+}
+
+std::uint64_t get_u64(const unsigned char* p)
+{
+  std::uint64_t v = 0;
+  for (std::size_t i = 0; i < kIdSize; ++i) v = (v << 8) | p[i];
+  return v;
+}
+}  // namespace
+
+std::shared_ptr<RpcClient> RpcClient::create(asio::io_context& io, const std::string& host, const std::string& port)
+{
+  return create(io, host, port, TcpClient::Options());
+}
+
+std::shared_ptr<RpcClient> RpcClient::create(asio::io_context& io, const std::string& host, const std::string& port,
+                                             const TcpClient::Options& socket_options)
+{
+  return std::shared_ptr<RpcClient>(new RpcClient(io, host, port, socket_options));
+}
+
+RpcClient::RpcClient(asio::io_context& io, const std::string& host, const std::string& port,
+                     const TcpClient::Options& socket_options) :
+  client_(std::make_shared<TcpClient>(io, host, port, socket_options)), wheel_(TimerWheel::get(io))
+{
+  client_->set_frame_codec(std::make_shared<LengthPrefixCodec>(LengthPrefixCodec::Prefix::U32));
+}
+
+void RpcClient::start()
+{
+  // 回调只持有弱引用，避免 RpcClient 与 TcpClient 相互持有
+  std::weak_ptr<RpcClient> weak = shared_from_this();
+  client_->set_message_view_callback([weak](asio::const_buffer frame) {
+    if (auto self = weak.lock()) self->on_frame(frame);
+  });
+  client_->set_status_callback([weak](TcpClient::Status s, const std::string& info) {
+    if (auto self = weak.lock()) self->on_status(s, info);
+  });
+  stopped_.store(false);
+  client_->start();
+}
+
+void RpcClient::stop()
+{
+  // 先标记再关闭: 关闭触发的断开状态回调据此以 operation_aborted 而非 connection_reset 结束在途请求
+  stopped_.store(true);
+  client_->stop();
+  auto self = shared_from_this();
+  asio::post(client_->get_executor(), [self] { self->fail_all(asio::error::operation_aborted); });
+}
+
+void RpcClient::async_request(std::string payload, std::chrono::steady_clock::duration deadline, Handler handler)
+{
+  auto self = shared_from_this();
+  // 已在客户端执行器上时直接执行，否则投递
+  asio::dispatch(client_->get_executor(), [self, payload, deadline, handler]() mutable {
+    self->do_request(payload, deadline, handler);
+  });
+}
+
+void RpcClient::set_status_callback(TcpClient::StatusCallback cb)
+{
+  on_status_ = std::move(cb);
+}
+
+std::size_t RpcClient::in_flight() const
+{
+  return in_flight_.load();
+}
+
+std::shared_ptr<TcpClient> RpcClient::client() const
+{
+  return client_;
+}
+
+void RpcClient::do_request(std::string& payload, Clock::duration deadline, Handler& handler)
+{
+  if (!client_->is_connected())
+  {
+    handler(asio::error::not_connected, std::string());
+    return;
+  }
+
+  std::uint64_t id = next_id_++;
+  if (next_id_ == 0) next_id_ = 1;  // 0 保留为空槽
+
+  std::string body;
+  body.reserve(kIdSize + payload.size());
+  put_u64(body, id);
+  body.append(payload);
+  std::string frame;
+  frame.reserve(body.size() + 4);
+  if (!LengthPrefixCodec(LengthPrefixCodec::Prefix::U32).encode(body.data(), body.size(), frame))
+  {
+    handler(asio::error::message_size, std::string());
+    return;
+  }
+
+  if (!client_->send(std::move(frame)))
+  {
+    handler(asio::error::no_buffer_space, std::string());
+    return;
+  }
+
+  std::size_t index;
+  if (free_slots_.empty())
+  {
+    index = slots_.size();
+    slots_.emplace_back();
+  }
+  else
+  {
+    index = free_slots_.back();
+    free_slots_.pop_back();
+  }
+  Pending& pending = slots_[index];
+  pending.handler = std::move(handler);
+  pending_.insert(id, index);
+  in_flight_.store(pending_.size());
+
+  // 时间轮回调在驱动它的 io 线程中执行，转到客户端执行器上以与收发回调串行
+  auto self = shared_from_this();
+  asio::any_io_executor ex = client_->get_executor();
+  wheel_.arm(pending.timer, deadline, [self, ex, id] { asio::dispatch(ex, [self, id] { self->on_timeout(id); }); });
+}
+
+void RpcClient::on_frame(asio::const_buffer frame)
+{
+  if (frame.size() < kIdSize) return;
+  const unsigned char* p = static_cast<const unsigned char*>(frame.data());
+  Handler handler = take(get_u64(p));
+  if (!handler) return;  // 已超时或未知的响应
+  try
+  {
+    handler(std::error_code(), std::string(reinterpret_cast<const char*>(p) + kIdSize, frame.size() - kIdSize));
+  }
+  catch (...)
+  {
+  }
+}
+
+void RpcClient::on_status(TcpClient::Status s, const std::string& info)
+{
+  // 断开后响应不会再到达
+  if (s != TcpClient::Status::Connected)
+    fail_all(stopped_.load() ? asio::error::operation_aborted : asio::error::connection_reset);
+  if (on_status_) on_status_(s, info);
+}
+
+void RpcClient::on_timeout(std::uint64_t id)
+{
+  Handler handler = take(id);
+  if (!handler) return;  // 响应先于超时到达
+  try
+  {
+    handler(asio::error::timed_out, std::string());
+  }
+  catch (...)
+  {
+  }
+}
+
+void RpcClient::fail_all(std::error_code ec)
+{
+  if (pending_.empty()) return;
+  // 先全部取出再回调，回调中可以安全地发起新请求
+  std::vector<std::uint64_t> ids;
+  ids.reserve(pending_.size());
+  pending_.for_each([&ids](std::uint64_t id, std::size_t&) { ids.push_back(id); });
+  std::vector<Handler> failed;
+  failed.reserve(ids.size());
+  for (std::uint64_t id : ids) failed.push_back(take(id));
+  for (auto& handler : failed)
+  {
+    try
+    {
+      handler(ec, std::string());
+    }
+    catch (...)
+    {
+    }
+  }
+}
+
+RpcClient::Handler RpcClient::take(std::uint64_t id)
+{
+  std::size_t index;
+  if (!pending_.erase(id, &index)) return Handler();
+  in_flight_.store(pending_.size());
+  Pending& pending = slots_[index];
+  wheel_.cancel(pending.timer);
+  Handler handler = std::move(pending.handler);
+  pending.handler = nullptr;
+  free_slots_.push_back(index);
+  return handler;
+}
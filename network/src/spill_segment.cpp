@@ -0,0 +1,158 @@
+#include "network/spill_segment.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+const std::size_t kHeaderSize = sizeof(std::uint32_t);
+const std::uint32_t kWrapMarker = UINT32_MAX;  // 回绕标记: 本条之后的数据从段首继续
+}  // namespace
+
+SpillSegment::SpillSegment() {}
+
+SpillSegment::~SpillSegment()
+{
+  close();
+}
+
+bool SpillSegment::open(const std::string& path, std::size_t capacity, std::error_code& ec)
+{
+  close();
+#if !defined(_WIN32)
+  int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+  if (fd < 0)
+  {
+    ec = std::error_code(errno, std::generic_category());
+    return false;
+  }
+  if (::ftruncate(fd, static_cast<off_t>(capacity)) != 0)
+  {
+    ec = std::error_code(errno, std::generic_category());
+    ::close(fd);
+    ::unlink(path.c_str());
+    return false;
+  }
+  void* p = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (p == MAP_FAILED)
+  {
+    ec = std::error_code(errno, std::generic_category());
+    ::close(fd);
+    ::unlink(path.c_str());
+    return false;
+  }
+  fd_ = fd;
+  base_ = static_cast<char*>(p);
+  capacity_ = capacity;
+  path_ = path;
+  read_ = write_ = records_ = bytes_ = 0;
+  wrapped_ = false;
+  ec.clear();
+  return true;
+#else
+  (void)path;
+  (void)capacity;
+  ec = std::make_error_code(std::errc::operation_not_supported);
+  return false;
+#endif
+}
+
+void SpillSegment::close()
+{
+#if !defined(_WIN32)
+  if (base_)
+  {
+    ::munmap(base_, capacity_);
+    ::close(fd_);
+    ::unlink(path_.c_str());
+    fd_ = -1;
+  }
+#endif
+  base_ = nullptr;
+  capacity_ = 0;
+  read_ = write_ = records_ = bytes_ = 0;
+  wrapped_ = false;
+}
+
+bool SpillSegment::is_open() const
+{
+  return base_ != nullptr;
+}
+
+bool SpillSegment::append(const char* data, std::size_t size)
+{
+  if (!base_ || size >= kWrapMarker) return false;
+  std::size_t need = kHeaderSize + size;
+  if (!wrapped_ && capacity_ - write_ < need)
+  {
+    // 尾部放不下: 头部已消费的空间够用时回绕（段为空时 read_ 与 write_ 已归零，不会走到这里还放得下）
+    if (read_ < need) return false;
+    if (capacity_ - write_ >= kHeaderSize) std::memcpy(base_ + write_, &kWrapMarker, kHeaderSize);
+    write_ = 0;
+    wrapped_ = true;
+  }
+  else if (wrapped_ && read_ - write_ < need)
+  {
+    return false;
+  }
+  std::uint32_t len = static_cast<std::uint32_t>(size);
+  std::memcpy(base_ + write_, &len, kHeaderSize);
+  std::memcpy(base_ + write_ + kHeaderSize, data, size);
+  write_ += need;
+  ++records_;
+  bytes_ += size;
+  return true;
+}
+
+std::size_t SpillSegment::peek(std::size_t max_records, std::vector<asio::const_buffer>& out) const
+{
+  std::size_t n = 0;
+  std::size_t offset = read_;
+  while (n < max_records && n < records_)
+  {
+    std::uint32_t len = record_at(offset);
+    out.push_back(asio::const_buffer(base_ + offset + kHeaderSize, len));
+    offset += kHeaderSize + len;
+    ++n;
+  }
+  return n;
+}
+
+void SpillSegment::consume(std::size_t records)
+{
+  while (records > 0 && records_ > 0)
+  {
+    std::uint32_t len = record_at(read_);
+    if (read_ == 0) wrapped_ = false;  // 读位置跟随回绕，数据重新连续
+    read_ += kHeaderSize + len;
+    bytes_ -= len;
+    --records_;
+    --records;
+  }
+  // 全部消费后从头复用，避免留下无法利用的尾部碎片
+  if (records_ == 0)
+  {
+    read_ = write_ = 0;
+    wrapped_ = false;
+  }
+}
+
+std::uint32_t SpillSegment::record_at(std::size_t& offset) const
+{
+  // 尾部不足一个长度前缀，或遇到回绕标记时，记录在段首
+  std::uint32_t len = kWrapMarker;
+  if (capacity_ - offset >= kHeaderSize) std::memcpy(&len, base_ + offset, kHeaderSize);
+  if (len == kWrapMarker)
+  {
+    offset = 0;
+    std::memcpy(&len, base_, kHeaderSize);
+  }
+  return len;
+}
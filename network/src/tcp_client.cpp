@@ -2,12 +2,57 @@
 
 #include <algorithm>
 #include <chrono>
+#include <random>
+
+#if !defined(_WIN32)
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#endif
+
+#include "network/buffer_range.h"
 
 using asio::ip::tcp;
 
+namespace
+{
+// 单次聚合写最多携带的缓冲区数, 与 asio 内部 iovec 上限保持一致
+const std::size_t kMaxWriteBuffers = asio::detail::buffer_sequence_adapter_base::max_buffers;
+
+// 平台相关的 TCP 层整型选项
+template <int Name>
+using TcpIntOption = asio::detail::socket_option::integer<IPPROTO_TCP, Name>;
+}  // namespace
+
 TcpClient::TcpClient(asio::io_context& io, const std::string& host, const std::string& port) :
-  io_(io), socket_(io), timer_(io), host_(host), port_(port)
+  TcpClient(io, host, port, Options())
+{
+}
+
+TcpClient::TcpClient(asio::io_context& io, const std::string& host, const std::string& port, const Options& options) :
+  TcpClient(io, host, port, options, false)
+{
+}
+
+TcpClient::TcpClient(asio::io_context& io, const asio::generic::stream_protocol::endpoint& endpoint,
+                     const Options& options) :
+  TcpClient(io, std::string(), std::string(), options, true)
 {
+  local_endpoint_ = endpoint;
+}
+
+TcpClient::TcpClient(asio::io_context& io, const std::string& host, const std::string& port, const Options& options,
+                     bool local) :
+  io_(io),
+  executor_(options.use_strand ? asio::any_io_executor(asio::make_strand(io))
+                               : asio::any_io_executor(io.get_executor())),
+  socket_(executor_),
+  wheel_(TimerWheel::get(io)),
+  options_(options),
+  local_(local),
+  dns_cache_(DnsCache::shared()),
+  handler_memory_(std::make_shared<HandlerMemory>())
+{
+  if (!local_) endpoints_.set_endpoints({Endpoint{host, port}});
 }
 
 void TcpClient::start()
@@ -19,6 +64,12 @@ void TcpClient::start()
 void TcpClient::stop()
 {
   stopped_.store(true);
+  cancel_timers();
+  {
+    // 唤醒因 Block 策略阻塞的发送线程
+    std::lock_guard<std::mutex> lock(block_mutex_);
+    block_cv_.notify_all();
+  }
   close();
 }
 
@@ -26,10 +77,106 @@ void TcpClient::set_message_callback(MessageCallback cb)
 {
   on_message_ = std::move(cb);
 }
+void TcpClient::set_message_view_callback(MessageViewCallback cb)
+{
+  on_message_view_ = std::move(cb);
+}
+std::shared_ptr<const std::vector<char>> TcpClient::retain_received()
+{
+  if (!retained_)
+  {
+    // 交出当前缓冲区，后续读取换用新的缓冲区
+    retained_ = std::make_shared<const std::vector<char>>(recv_buf_.detach());
+  }
+  return retained_;
+}
+void TcpClient::set_frame_codec(std::shared_ptr<FrameCodec> codec)
+{
+  codec_ = std::move(codec);
+}
 void TcpClient::set_status_callback(StatusCallback cb)
 {
   on_status_ = std::move(cb);
 }
+void TcpClient::set_flush_callback(FlushCallback cb)
+{
+  on_flush_ = std::move(cb);
+}
+void TcpClient::set_heartbeat(std::chrono::milliseconds interval, std::string payload)
+{
+  heartbeat_interval_ = interval;
+  heartbeat_payload_ = std::move(payload);
+}
+void TcpClient::set_idle_timeout(std::chrono::milliseconds timeout)
+{
+  idle_timeout_ = timeout;
+}
+void TcpClient::set_reconnect_policy(const ReconnectPolicy& policy)
+{
+  reconnect_policy_ = policy;
+  if (reconnect_policy_.base.count() <= 0) reconnect_policy_.base = std::chrono::milliseconds(1);
+  if (reconnect_policy_.max_delay < reconnect_policy_.base) reconnect_policy_.max_delay = reconnect_policy_.base;
+}
+void TcpClient::set_send_queue_limits(const SendQueueLimits& limits)
+{
+  limits_ = limits;
+}
+void TcpClient::set_offline_policy(const OfflinePolicy& policy)
+{
+  offline_ = policy;
+}
+void TcpClient::set_watermark_callback(WatermarkCallback cb)
+{
+  on_watermark_ = std::move(cb);
+}
+std::size_t TcpClient::queued_bytes() const
+{
+  return queued_bytes_.load();
+}
+std::size_t TcpClient::queued_messages() const
+{
+  return queued_messages_.load();
+}
+HandlerAllocator<void> TcpClient::handler_allocator() const
+{
+  return HandlerAllocator<void>(handler_memory_);
+}
+
+std::uint64_t TcpClient::handler_fallbacks() const
+{
+  return handler_memory_->fallbacks();
+}
+
+asio::any_io_executor TcpClient::get_executor() const
+{
+  return executor_;
+}
+TcpClientMetrics::Snapshot TcpClient::metrics() const
+{
+  TcpClientMetrics::Snapshot snapshot = metrics_.snapshot();
+  snapshot.write_queue_depth = queued_messages_.load();
+  return snapshot;
+}
+void TcpClient::set_endpoints(const std::vector<Endpoint>& endpoints)
+{
+  if (local_) return;
+  endpoints_.set_endpoints(endpoints);
+}
+
+void TcpClient::set_failover_policy(const FailoverPolicy& policy)
+{
+  endpoints_.set_policy(policy);
+}
+
+std::vector<TcpClient::EndpointStats> TcpClient::endpoint_stats() const
+{
+  return endpoints_.stats();
+}
+
+void TcpClient::set_dns_cache(std::shared_ptr<DnsCache> cache)
+{
+  dns_cache_ = cache ? std::move(cache) : DnsCache::shared();
+}
 TcpClient::Status TcpClient::get_status() const
 {
   return current_status_.load();
@@ -40,20 +187,111 @@ bool TcpClient::is_connected() const
   return get_status() == Status::Connected;
 }
 
-void TcpClient::send(const std::string& msg)
+bool TcpClient::send(const std::string& msg)
 {
-  auto self = shared_from_this();
-  asio::post(io_, [this, self, msg] {
-    if (stopped_.load()) return;
-    bool writing = !write_msgs_.empty();
-    write_msgs_.push_back(msg);
-    if (!writing) do_write();
-  });
+  return send(std::string(msg));
+}
+
+bool TcpClient::send(std::string&& msg)
+{
+  if (!reserve_queue(msg.size())) return false;
+  send_queue_.push(std::move(msg));
+  if (!doorbell_.exchange(true))
+  {
+    auto self = shared_from_this();
+    asio::post(executor_, asio::bind_allocator(handler_allocator(), [this, self] { drain_send_queue(); }));
+  }
+  return true;
+}
+
+void TcpClient::drain_send_queue()
+{
+  // 先复位门铃再取数据，之后入队的生产者会重新投递
+  doorbell_.store(false);
+  std::string msg;
+  while (send_queue_.pop(msg))
+  {
+    if (stopped_.load())
+    {
+      release_queue(1, msg.size());
+      continue;
+    }
+    if (should_spill(msg.size()) && spill(msg))
+    {
+      // 落盘的消息不再占用发送队列配额
+      release_queue(1, msg.size());
+      continue;
+    }
+    enqueue_memory(std::move(msg));
+    if (limits_.policy == OverflowPolicy::DropOldest) drop_oldest();
+  }
+  do_write();
+}
+
+bool TcpClient::should_spill(std::size_t size) const
+{
+  // 已连接时不落盘: 溢出段非空也只是排在段后等待回放，不再向段中追加
+  if (!offline_.enabled || offline_.spill_path.empty() || spill_unavailable_ || is_connected()) return false;
+  return memory_bytes_ + size > offline_.memory_limit;
+}
+
+bool TcpClient::spill(const std::string& msg)
+{
+  if (!spill_.is_open())
+  {
+    std::error_code ec;
+    if (!spill_.open(offline_.spill_path, offline_.spill_capacity, ec))
+    {
+      // 无法创建段文件时退回内存缓冲
+      spill_unavailable_ = true;
+      set_status(current_status_.load(), "Spill segment unavailable: " + ec.message());
+      return false;
+    }
+  }
+  // 排在段后的内存消息早于本条，先按顺序写入段中
+  while (!spill_tail_.empty())
+  {
+    const std::string& front = spill_tail_.front();
+    if (!spill_.append(front.data(), front.size())) break;
+    metrics_.on_spilled(front.size());
+    memory_bytes_ -= front.size();
+    release_queue(1, front.size());
+    spill_tail_.pop_front();
+  }
+  if (!spill_tail_.empty() || !spill_.append(msg.data(), msg.size()))
+  {
+    // 段已写满: 消息留在内存中，待回放腾出空间
+    metrics_.on_spill_full();
+    return false;
+  }
+  metrics_.on_spilled(msg.size());
+  return true;
+}
+
+void TcpClient::enqueue_memory(std::string msg)
+{
+  memory_bytes_ += msg.size();
+  if (spill_.empty())
+    write_msgs_.push_back(std::move(msg));
+  else
+    spill_tail_.push_back(std::move(msg));
+}
+
+bool TcpClient::send_frame(const std::string& payload)
+{
+  if (!codec_) return send(payload);
+  std::string frame;
+  if (!codec_->encode(payload.data(), payload.size(), frame)) return false;
+  return send(std::move(frame));
 }
 
 void TcpClient::set_status(Status s, const std::string& info)
 {
   current_status_.store(s);
+  if (s == Status::Connected)
+    metrics_.on_connected();
+  else
+    metrics_.on_disconnected();
   try
   {
     if (on_status_) on_status_(s, info);
@@ -66,99 +304,676 @@ void TcpClient::set_status(Status s, const std::string& info)
 void TcpClient::do_connect()
 {
   if (stopped_.load()) return;
-  tcp::resolver resolver(io_);
-  auto endpoints = resolver.resolve(host_, port_);
   auto self = shared_from_this();
-  asio::async_connect(socket_, endpoints, [this, self](std::error_code ec, tcp::endpoint) {
+  ConnectRateLimiter::get(io_).acquire([this, self] {
+    asio::dispatch(executor_, asio::bind_allocator(handler_allocator(), [this, self] { do_resolve_and_connect(); }));
+  });
+}
+
+void TcpClient::do_resolve_and_connect()
+{
+  if (stopped_.load()) return;
+  auto self = shared_from_this();
+  if (local_)
+  {
+    // 本地套接字没有地址解析，也没有可竞速的多个地址
+    connect_started_ = std::chrono::steady_clock::now();
+    socket_.async_connect(local_endpoint_, asio::bind_allocator(handler_allocator(), [this, self](std::error_code ec) {
+                            if (stopped_.load()) return;
+                            if (!ec)
+                              on_connected();
+                            else
+                              on_connect_failed(ec);
+                          }));
+    return;
+  }
+  Endpoint endpoint = endpoints_.select();
+  // 解析结果直接投递到本客户端的执行器（启用 strand 时即 strand）
+  dns_cache_->async_resolve(io_, executor_, endpoint.host, endpoint.port,
+                            [this, self](std::error_code ec, DnsCache::Results endpoints) {
+                              on_resolved(ec, endpoints);
+                            });
+}
+
+void TcpClient::on_resolved(std::error_code ec, const DnsCache::Results& endpoints)
+{
+  if (stopped_.load()) return;
+  if (ec)
+  {
+    set_status(Status::Error, "Resolve failed: " + ec.message());
+    schedule_reconnect();
+    return;
+  }
+  connect_started_ = std::chrono::steady_clock::now();
+  if (options_.happy_eyeballs)
+  {
+    start_race(endpoints);
+    return;
+  }
+  auto self = shared_from_this();
+  auto on_connect = [this, self](std::error_code ec, const asio::generic::stream_protocol::endpoint&) {
     if (stopped_.load()) return;
     if (!ec)
-    {
-      reconnect_delay_ = 1;
-      set_status(Status::Connected, "Connected to server");
-      do_read();
-    }
+      on_connected();
     else
+      on_connect_failed(ec);
+  };
+  // 套接字与协议无关，解析结果的条目需先转换为通用端点
+  std::vector<asio::generic::stream_protocol::endpoint> candidates;
+  for (const auto& entry : endpoints) candidates.push_back(entry.endpoint());
+  asio::async_connect(socket_, candidates, asio::bind_allocator(handler_allocator(), on_connect));
+}
+
+void TcpClient::on_connected()
+{
+  reconnect_delay_ = std::chrono::milliseconds(0);
+  recv_buf_.clear();
+  if (codec_) codec_->reset();
+  apply_options(socket_, options_, !local_);
+  set_status(Status::Connected, "Connected to server");
+  start_keepalive_timers();
+  do_read();
+  do_write();  // 发出断线期间积压的消息
+  if (!endpoints_.empty())
+  {
+    endpoints_.on_connected();
+    // 连接建立耗时（含握手）作为一个往返样本；放在读循环启动之后，据此切换端点时挂起的读操作正常结束
+    auto elapsed = std::chrono::steady_clock::now() - connect_started_;
+    on_rtt_sample(std::chrono::duration<double, std::micro>(elapsed).count());
+  }
+}
+
+void TcpClient::on_connect_failed(const std::error_code& ec)
+{
+  set_status(Status::Error, "Connect failed: " + ec.message());
+  schedule_reconnect();
+}
+
+struct TcpClient::ConnectRace
+{
+  explicit ConnectRace(const asio::any_io_executor& ex) : timer(ex) {}
+
+  std::vector<tcp::endpoint> endpoints;                  // 交错排序后的候选地址
+  std::vector<std::unique_ptr<tcp::socket>> attempts;   // 已发起的尝试，与 endpoints 前缀一一对应
+  asio::steady_timer timer;                              // 错时发起下一个尝试
+  std::size_t outstanding = 0;                           // 尚未完成的尝试数
+  bool done = false;                                     // 已有胜者或已放弃
+  std::error_code last_error;
+};
+
+void TcpClient::start_race(const DnsCache::Results& endpoints)
+{
+  auto race = std::make_shared<ConnectRace>(executor_);
+
+  // 按地址族分组，保持各组内的解析顺序；上次胜出的地址族排第一，否则沿用解析结果的首个地址族
+  std::vector<tcp::endpoint> first, second;
+  int lead = preferred_family_;
+  for (const auto& entry : endpoints)
+  {
+    tcp::endpoint ep = entry.endpoint();
+    if (lead == 0) lead = ep.protocol().family();
+    (ep.protocol().family() == lead ? first : second).push_back(ep);
+  }
+  for (std::size_t i = 0; i < first.size() || i < second.size(); ++i)
+  {
+    if (i < first.size()) race->endpoints.push_back(first[i]);
+    if (i < second.size()) race->endpoints.push_back(second[i]);
+  }
+  if (race->endpoints.empty())
+  {
+    on_connect_failed(asio::error::host_not_found);
+    return;
+  }
+
+  race_ = race;
+  launch_attempt(race);
+}
+
+void TcpClient::launch_attempt(const std::shared_ptr<ConnectRace>& race)
+{
+  if (race->done || race->attempts.size() >= race->endpoints.size()) return;
+
+  std::size_t index = race->attempts.size();
+  race->attempts.emplace_back(new tcp::socket(executor_));
+  ++race->outstanding;
+  auto self = shared_from_this();
+  race->attempts[index]->async_connect(
+    race->endpoints[index],
+    asio::bind_allocator(handler_allocator(),
+                         [this, self, race, index](std::error_code ec) { on_attempt(race, index, ec); }));
+
+  if (race->attempts.size() < race->endpoints.size())
+  {
+    race->timer.expires_after(std::chrono::milliseconds(options_.happy_eyeballs_delay_ms));
+    race->timer.async_wait(asio::bind_allocator(handler_allocator(), [this, self, race](std::error_code ec) {
+      if (!ec) launch_attempt(race);
+    }));
+  }
+}
+
+void TcpClient::on_attempt(const std::shared_ptr<ConnectRace>& race, std::size_t index, const std::error_code& ec)
+{
+  --race->outstanding;
+  if (race->done || stopped_.load()) return;
+
+  if (!ec)
+  {
+    // 取胜者，取消其余尝试和定时器
+    race->done = true;
+    race->timer.cancel();
+    for (std::size_t i = 0; i < race->attempts.size(); ++i)
     {
-      set_status(Status::Error, "Connect failed: " + ec.message());
-      schedule_reconnect();
+      std::error_code ignored;
+      if (i != index) race->attempts[i]->close(ignored);
     }
-  });
+    socket_ = std::move(*race->attempts[index]);
+    preferred_family_ = race->endpoints[index].protocol().family();
+    race_.reset();
+    on_connected();
+    return;
+  }
+
+  race->last_error = ec;
+  if (race->attempts.size() < race->endpoints.size())
+  {
+    // 失败时不必等满错时间隔，立即发起下一个
+    race->timer.cancel();
+    launch_attempt(race);
+  }
+  else if (race->outstanding == 0)
+  {
+    race->done = true;
+    race_.reset();
+    on_connect_failed(race->last_error);
+  }
+}
+
+void TcpClient::abort_race()
+{
+  if (!race_) return;
+  race_->done = true;
+  race_->timer.cancel();
+  for (auto& attempt : race_->attempts)
+  {
+    std::error_code ignored;
+    attempt->close(ignored);
+  }
+  race_.reset();
+}
+
+void TcpClient::apply_socket_options(tcp::socket& socket, const Options& options)
+{
+  apply_options(socket, options, true);
+}
+
+template <typename SocketType>
+void TcpClient::apply_options(SocketType& socket, const Options& options, bool tcp_level)
+{
+  // 尽力而为: 单个选项设置失败不影响连接
+  std::error_code ec;
+  if (options.send_buffer_size > 0)
+    socket.set_option(asio::socket_base::send_buffer_size(options.send_buffer_size), ec);
+  if (options.receive_buffer_size > 0)
+    socket.set_option(asio::socket_base::receive_buffer_size(options.receive_buffer_size), ec);
+  // 以下为 TCP 层选项，本地套接字上没有意义
+  if (!tcp_level) return;
+  if (options.no_delay) socket.set_option(tcp::no_delay(true), ec);
+  if (options.keep_alive)
+  {
+    socket.set_option(asio::socket_base::keep_alive(true), ec);
+#if defined(TCP_KEEPIDLE)
+    if (options.keep_alive_idle > 0) socket.set_option(TcpIntOption<TCP_KEEPIDLE>(options.keep_alive_idle), ec);
+#elif defined(TCP_KEEPALIVE)  // macOS
+    if (options.keep_alive_idle > 0) socket.set_option(TcpIntOption<TCP_KEEPALIVE>(options.keep_alive_idle), ec);
+#endif
+#if defined(TCP_KEEPINTVL)
+    if (options.keep_alive_interval > 0)
+      socket.set_option(TcpIntOption<TCP_KEEPINTVL>(options.keep_alive_interval), ec);
+#endif
+#if defined(TCP_KEEPCNT)
+    if (options.keep_alive_count > 0) socket.set_option(TcpIntOption<TCP_KEEPCNT>(options.keep_alive_count), ec);
+#endif
+  }
+#if defined(TCP_USER_TIMEOUT)
+  if (options.user_timeout_ms > 0)
+    socket.set_option(TcpIntOption<TCP_USER_TIMEOUT>(static_cast<int>(options.user_timeout_ms)), ec);
+#endif
+#if defined(TCP_QUICKACK)
+  if (options.quick_ack) socket.set_option(TcpIntOption<TCP_QUICKACK>(1), ec);
+#endif
 }
 
 void TcpClient::schedule_reconnect()
 {
-  if (stopped_.load()) return;
-  set_status(Status::Reconnecting, "Retry in " + std::to_string(reconnect_delay_) + "s");
+  if (stopped_.load() || reconnect_pending_) return;
+  cancel_timers();
+  reconnect_pending_ = true;
+  // 主动切换端点不是端点故障，立即重连
+  if (!switching_) endpoints_.on_failure();
+  std::chrono::milliseconds delay = switching_ ? std::chrono::milliseconds(0) : next_reconnect_delay();
+  set_status(Status::Reconnecting, "Retry in " + std::to_string(delay.count()) + "ms");
   auto self = shared_from_this();
-  timer_.expires_after(std::chrono::seconds(reconnect_delay_));
-  timer_.async_wait([this, self](std::error_code ec) {
-    if (!ec && !stopped_.load())
-    {
-      socket_ = tcp::socket(io_);
-      do_connect();
-      reconnect_delay_ = std::min(reconnect_delay_ * 2, 30);
-    }
+  // 重复调用时重新计时（例如读写同时失败）
+  arm_timer(reconnect_timer_, delay, [this, self] {
+    reconnect_pending_ = false;
+    switching_ = false;
+    if (stopped_.load()) return;
+    metrics_.on_reconnect();
+    socket_ = Socket(executor_);
+    do_connect();
   });
 }
 
+std::chrono::milliseconds TcpClient::next_reconnect_delay()
+{
+  const ReconnectPolicy& p = reconnect_policy_;
+  std::chrono::milliseconds delay;
+  if (!p.jitter)
+  {
+    delay = reconnect_delay_.count() == 0 ? p.base : std::min(reconnect_delay_ * 2, p.max_delay);
+  }
+  else
+  {
+    // 去相关抖动: 在 [base, 上次延迟 * 3] 内均匀随机
+    static thread_local std::mt19937 rng{std::random_device{}()};
+    std::chrono::milliseconds prev = std::max(reconnect_delay_, p.base);
+    std::uniform_int_distribution<long long> dist(p.base.count(), std::max(prev.count() * 3, p.base.count()));
+    delay = std::min(std::chrono::milliseconds(dist(rng)), p.max_delay);
+  }
+  reconnect_delay_ = delay;
+  return delay;
+}
+
+void TcpClient::start_keepalive_timers()
+{
+  auto self = shared_from_this();
+  if (heartbeat_interval_.count() > 0)
+  {
+    heartbeat_mark_ = metrics_.bytes_sent();
+    arm_timer(heartbeat_timer_, heartbeat_interval_, [this, self] { on_heartbeat_timer(); });
+  }
+  if (idle_timeout_.count() > 0)
+  {
+    idle_mark_ = metrics_.bytes_received();
+    arm_timer(idle_timer_, idle_timeout_, [this, self] { on_idle_timer(); });
+  }
+  ping_outstanding_ = false;
+  const FailoverPolicy& failover = endpoints_.policy();
+  if (!endpoints_.empty() && failover.ping_interval.count() > 0 && failover.is_pong)
+    arm_timer(ping_timer_, failover.ping_interval, [this, self] { on_ping_timer(); });
+}
+
+void TcpClient::cancel_timers()
+{
+  wheel_.cancel(heartbeat_timer_);
+  wheel_.cancel(idle_timer_);
+  wheel_.cancel(ping_timer_);
+  wheel_.cancel(reconnect_timer_);
+  reconnect_pending_ = false;
+}
+
+void TcpClient::arm_timer(TimerWheel::Timer& timer, std::chrono::steady_clock::duration delay,
+                          std::function<void()> fn)
+{
+  // 时间轮回调在驱动它的 io 线程中执行，转到客户端执行器上以保持串行
+  asio::any_io_executor ex = executor_;
+  HandlerAllocator<void> alloc = handler_allocator();
+  wheel_.arm(timer, delay, [ex, alloc, fn] { asio::dispatch(ex, asio::bind_allocator(alloc, fn)); });
+}
+
+void TcpClient::on_heartbeat_timer()
+{
+  if (stopped_.load() || !is_connected()) return;
+  // 本周期内没有写出任何数据，且发送队列为空时才发送心跳
+  if (metrics_.bytes_sent() == heartbeat_mark_ && queued_messages_.load() == 0) send(heartbeat_payload_);
+  heartbeat_mark_ = metrics_.bytes_sent();
+  auto self = shared_from_this();
+  arm_timer(heartbeat_timer_, heartbeat_interval_, [this, self] { on_heartbeat_timer(); });
+}
+
+void TcpClient::on_idle_timer()
+{
+  if (stopped_.load() || !is_connected()) return;
+  if (metrics_.bytes_received() == idle_mark_)
+  {
+    // 关闭套接字，挂起的读操作失败后走正常的重连流程
+    set_status(Status::Error, "Idle timeout: no data received");
+    std::error_code ec;
+    socket_.close(ec);
+    return;
+  }
+  idle_mark_ = metrics_.bytes_received();
+  auto self = shared_from_this();
+  arm_timer(idle_timer_, idle_timeout_, [this, self] { on_idle_timer(); });
+}
+
+void TcpClient::on_rtt_sample(double rtt_us)
+{
+  double srtt = 0;
+  if (!endpoints_.on_rtt_sample(rtt_us, srtt) || !is_connected()) return;
+
+  // 与读空闲超时相同: 关闭套接字，挂起的读写操作以 operation_aborted 结束后进入重连流程（不再重复报告错误），
+  // 重连时选中更优的端点
+  metrics_.on_failover();
+  switching_ = true;
+  set_status(Status::Error, "RTT degraded: srtt " + std::to_string(static_cast<long long>(srtt / 1000)) +
+                              "ms, switching endpoint");
+  std::error_code ec;
+  socket_.close(ec);
+}
+
+void TcpClient::on_ping_timer()
+{
+  if (stopped_.load() || !is_connected()) return;
+  if (ping_outstanding_)
+  {
+    // 上一个探测帧在整个周期内未得到应答，以已等待的时间记一个样本
+    on_rtt_sample(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - ping_sent_).count());
+    if (!is_connected()) return;
+  }
+  else
+  {
+    ping_outstanding_ = true;
+    ping_sent_ = std::chrono::steady_clock::now();
+    send_frame(endpoints_.policy().ping_payload);
+  }
+  auto self = shared_from_this();
+  arm_timer(ping_timer_, endpoints_.policy().ping_interval, [this, self] { on_ping_timer(); });
+}
+
+bool TcpClient::consume_pong(const char* data, std::size_t size)
+{
+  const FailoverPolicy& failover = endpoints_.policy();
+  if (!ping_outstanding_ || !failover.is_pong || !failover.is_pong(asio::const_buffer(data, size))) return false;
+  ping_outstanding_ = false;
+  on_rtt_sample(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - ping_sent_).count());
+  return true;
+}
+
 void TcpClient::do_read()
 {
   if (stopped_.load()) return;
   auto self = shared_from_this();
-  socket_.async_read_some(asio::buffer(read_buf_), [this, self](std::error_code ec, std::size_t length) {
+  auto on_read = [this, self](std::error_code ec, std::size_t length) {
     if (stopped_.load()) return;
     if (!ec)
     {
-      std::string msg(read_buf_.data(), length);
-      try
+      recv_buf_.commit(length);
+      metrics_.on_received_bytes(length);
+#if defined(TCP_QUICKACK)
+      if (options_.quick_ack && !local_)
       {
-        if (on_message_) on_message_(msg);
+        std::error_code ignored;
+        socket_.set_option(TcpIntOption<TCP_QUICKACK>(1), ignored);
       }
-      catch (...)
+#endif
+      if (!dispatch_received())
       {
+        std::error_code ignored;
+        socket_.close(ignored);
+        set_status(Status::Error, "Frame error: invalid or oversized frame");
+        schedule_reconnect();
+        return;
       }
       do_read();
     }
     else
     {
-      if (ec == asio::error::eof || ec == asio::error::connection_reset)
+      // 主动切换端点时已报告过状态，这里只进入重连流程
+      if (switching_)
+      {
+      }
+      else if (ec == asio::error::eof || ec == asio::error::connection_reset)
         set_status(Status::Disconnected, "Server closed");
       else
         set_status(Status::Error, "Read error: " + ec.message());
       schedule_reconnect();
     }
-  });
+  };
+  socket_.async_read_some(recv_buf_.prepare(), asio::bind_allocator(handler_allocator(), on_read));
+}
+
+bool TcpClient::dispatch_received()
+{
+  if (!codec_)
+  {
+    // 未分帧: 原样交付本次读取到的数据
+    const char* data = recv_buf_.data();
+    std::size_t size = recv_buf_.size();
+    recv_buf_.consume(size);
+    deliver(data, size);
+    return true;
+  }
+
+  std::error_code ec;
+  while (!recv_buf_.empty())
+  {
+    const char* frame = nullptr;
+    std::size_t frame_size = 0;
+    std::size_t consumed = codec_->decode(recv_buf_.data(), recv_buf_.size(), frame, frame_size, ec);
+    if (ec) return false;
+    if (consumed == 0) break;
+    recv_buf_.consume(consumed);
+    deliver(frame, frame_size);
+  }
+  return true;
+}
+
+void TcpClient::deliver(const char* data, std::size_t size)
+{
+  if (ping_outstanding_ && consume_pong(data, size)) return;
+  metrics_.on_received_message();
+  try
+  {
+    if (on_message_view_) on_message_view_(asio::const_buffer(data, size));
+    if (on_message_) on_message_(std::string(data, size));
+  }
+  catch (...)
+  {
+  }
+  retained_.reset();
 }
 
 void TcpClient::do_write()
 {
-  if (stopped_.load()) return;
+  // 未连接时不向失效的套接字写（与是否启用离线缓冲无关），消息留在队列中，连接成功后再发起
+  if (stopped_.load() || writing_ || !is_connected()) return;
+
+  write_bufs_.clear();
+  std::size_t replay = 0;  // 本次回放的溢出段记录数
+  if (!write_msgs_.empty())
+  {
+    // 把写开始时队列里已有的消息一次性移入 writing_msgs_(不超过 iovec 上限)
+    // 先移动再取缓冲区地址，写期间 send() 继续向 write_msgs_ 入队不会影响正在写出的数据
+    std::size_t count = std::min(write_msgs_.size(), kMaxWriteBuffers);
+    writing_msgs_.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      memory_bytes_ -= write_msgs_.front().size();
+      writing_msgs_.push_back(std::move(write_msgs_.front()));
+      write_msgs_.pop_front();
+    }
+    for (const auto& m : writing_msgs_)
+    {
+      write_bufs_.push_back(asio::buffer(m));
+    }
+  }
+  else if (!spill_.empty())
+  {
+    // 内存中的消息都早于溢出段，发完后直接从映射区回放，不复制到堆上
+    replay = spill_.peek(kMaxWriteBuffers, write_bufs_);
+  }
+  else
+  {
+    return;
+  }
+
+  writing_ = true;
+  write_start_ns_ = TcpClientMetrics::now_ns();
   auto self = shared_from_this();
-  asio::async_write(socket_, asio::buffer(write_msgs_.front()), [this, self](std::error_code ec, std::size_t) {
-    if (stopped_.load()) return;
+  auto on_write = [this, self, replay](std::error_code ec, std::size_t length) {
+    writing_ = false;
     if (!ec)
     {
-      write_msgs_.pop_front();
-      if (!write_msgs_.empty()) do_write();
+      std::size_t batch = replay ? replay : writing_msgs_.size();
+      writing_msgs_.clear();
+      metrics_.on_sent(batch, length);
+      metrics_.on_write_latency(TcpClientMetrics::now_ns() - write_start_ns_);
+      if (replay)
+      {
+        spill_.consume(replay);
+        metrics_.on_replayed(replay, length);
+        if (spill_.empty())
+        {
+          // 段已回放完，排在段后的消息转入写队列（回放期间写队列为空）
+          while (!spill_tail_.empty())
+          {
+            write_msgs_.push_back(std::move(spill_tail_.front()));
+            spill_tail_.pop_front();
+          }
+        }
+      }
+      else
+      {
+        release_queue(batch, length);
+      }
+      if (stopped_.load()) return;
+      try
+      {
+        if (on_flush_) on_flush_(batch, length);
+      }
+      catch (...)
+      {
+      }
+      do_write();
     }
     else
     {
-      set_status(Status::Error, "Write error: " + ec.message());
+      // 未确认写出的消息放回队首，重连后再次发送（回放的记录仍留在溢出段中）
+      for (auto it = writing_msgs_.rbegin(); it != writing_msgs_.rend(); ++it)
+      {
+        memory_bytes_ += it->size();
+        write_msgs_.push_front(std::move(*it));
+      }
+      writing_msgs_.clear();
+      if (stopped_.load()) return;
+      if (!switching_) set_status(Status::Error, "Write error: " + ec.message());
       schedule_reconnect();
     }
-  });
+  };
+  // 以指针区间引用 write_bufs_，避免 async_write 在操作对象里复制一份 vector
+  asio::async_write(socket_, BufferRange(write_bufs_), asio::bind_allocator(handler_allocator(), on_write));
+}
+
+bool TcpClient::over_limit(std::size_t messages, std::size_t bytes) const
+{
+  if ((limits_.max_bytes && bytes > limits_.max_bytes) || (limits_.max_messages && messages > limits_.max_messages))
+    return true;
+  // 离线缓冲不落盘时，离线期间 memory_limit 即内存中待发字节数的上限
+  return offline_.enabled && offline_.spill_path.empty() && bytes > offline_.memory_limit && !is_connected();
+}
+
+bool TcpClient::reserve_queue(std::size_t bytes)
+{
+  bool limited = limits_.max_bytes || limits_.max_messages || (offline_.enabled && offline_.spill_path.empty());
+  if (limits_.policy == OverflowPolicy::DropOldest || !limited)
+  {
+    // 不限制或超限时由 io 线程丢弃旧消息，这里只记账
+    metrics_.on_queue_depth(queued_messages_.fetch_add(1) + 1);
+    queued_bytes_.fetch_add(bytes);
+  }
+  else
+  {
+    // 单条消息本身就超过上限时永远无法入队
+    if (limits_.max_bytes && bytes > limits_.max_bytes) return false;
+
+    bool can_block =
+      limits_.policy == OverflowPolicy::Block && !io_.get_executor().running_in_this_thread() && !stopped_.load();
+    for (;;)
+    {
+      // 先乐观地占用配额，超限再退回，保证并发发送时不会同时越过上限
+      std::size_t msgs = queued_messages_.fetch_add(1) + 1;
+      std::size_t total = queued_bytes_.fetch_add(bytes) + bytes;
+      if (!over_limit(msgs, total))
+      {
+        metrics_.on_queue_depth(msgs);
+        break;
+      }
+      queued_messages_.fetch_sub(1);
+      queued_bytes_.fetch_sub(bytes);
+      if (!can_block) return false;
+
+      std::unique_lock<std::mutex> lock(block_mutex_);
+      ++blocked_senders_;
+      block_cv_.wait_for(lock, std::chrono::milliseconds(100), [this, bytes] {
+        return stopped_.load() ||
+               !over_limit(queued_messages_.load() + 1, queued_bytes_.load() + bytes);
+      });
+      --blocked_senders_;
+      if (stopped_.load()) return false;
+    }
+  }
+
+  if (limits_.high_watermark && queued_bytes_.load() > limits_.high_watermark && !above_high_.exchange(true))
+  {
+    try
+    {
+      if (on_watermark_) on_watermark_(true, queued_bytes_.load());
+    }
+    catch (...)
+    {
+    }
+  }
+  return true;
+}
+
+void TcpClient::release_queue(std::size_t messages, std::size_t bytes)
+{
+  queued_messages_.fetch_sub(messages);
+  std::size_t remaining = queued_bytes_.fetch_sub(bytes) - bytes;
+
+  if (above_high_.load() && remaining <= limits_.low_watermark && above_high_.exchange(false))
+  {
+    try
+    {
+      if (on_watermark_) on_watermark_(false, remaining);
+    }
+    catch (...)
+    {
+    }
+  }
+
+  if (blocked_senders_.load() > 0)
+  {
+    std::lock_guard<std::mutex> lock(block_mutex_);
+    block_cv_.notify_all();
+  }
+}
+
+void TcpClient::drop_oldest()
+{
+  while (write_msgs_.size() + spill_tail_.size() > 1 && over_limit(queued_messages_.load(), queued_bytes_.load()))
+  {
+    // 只丢弃尚未开始写出的内存消息（溢出段前的早于段后的），新入队的这一条总是保留
+    RingQueue<std::string>& queue = write_msgs_.empty() ? spill_tail_ : write_msgs_;
+    std::size_t size = queue.front().size();
+    memory_bytes_ -= size;
+    queue.pop_front();
+    release_queue(1, size);
+  }
 }
 
 void TcpClient::close()
 {
   auto self = shared_from_this();
-  asio::post(io_, [this, self] {
+  asio::post(executor_, asio::bind_allocator(handler_allocator(), [this, self] {
+    abort_race();
     std::error_code ec;
     if (socket_.is_open())
     {
-      socket_.shutdown(tcp::socket::shutdown_both, ec);
+      socket_.shutdown(asio::socket_base::shutdown_both, ec);
       socket_.close(ec);
       set_status(Status::Disconnected, "Client closed");
     }
-  });
+  }));
 }
@@ -0,0 +1,186 @@
+#include "network/tcp_client_metrics.h"
+
+#include <chrono>
+
+LatencyHistogram::LatencyHistogram()
+{
+  for (auto& c : counts_) c.store(0, std::memory_order_relaxed);
+}
+
+unsigned LatencyHistogram::bucket_of(std::uint64_t ns)
+{
+  if (ns < kSubBuckets) return static_cast<unsigned>(ns);
+  unsigned exponent = 63;
+  while (!(ns >> exponent)) --exponent;  // floor(log2(ns)), 此处 exponent >= kSubBits
+  if (exponent > kMaxExponent) return kBuckets - 1;
+  unsigned sub = static_cast<unsigned>(ns >> (exponent - kSubBits)) & (kSubBuckets - 1);
+  return (exponent - kSubBits + 1) * kSubBuckets + sub;
+}
+
+std::uint64_t LatencyHistogram::bucket_upper(unsigned bucket)
+{
+  if (bucket < kSubBuckets) return bucket;
+  unsigned exponent = bucket / kSubBuckets - 1 + kSubBits;
+  std::uint64_t sub = bucket % kSubBuckets;
+  std::uint64_t width = std::uint64_t(1) << (exponent - kSubBits);
+  return ((kSubBuckets + sub) << (exponent - kSubBits)) + width - 1;
+}
+
+void LatencyHistogram::record(std::uint64_t ns)
+{
+  counts_[bucket_of(ns)].fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(ns, std::memory_order_relaxed);
+  std::uint64_t prev = max_.load(std::memory_order_relaxed);
+  while (ns > prev && !max_.compare_exchange_weak(prev, ns, std::memory_order_relaxed))
+  {
+  }
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const
+{
+  Snapshot s;
+  s.counts.resize(kBuckets);
+  for (unsigned i = 0; i < kBuckets; ++i)
+  {
+    s.counts[i] = counts_[i].load(std::memory_order_relaxed);
+    s.count += s.counts[i];
+  }
+  s.sum = sum_.load(std::memory_order_relaxed);
+  s.max = max_.load(std::memory_order_relaxed);
+  return s;
+}
+
+std::uint64_t LatencyHistogram::Snapshot::percentile(double q) const
+{
+  if (count == 0) return 0;
+  if (q <= 0) q = 0;
+  if (q >= 1) return max;
+  std::uint64_t rank = static_cast<std::uint64_t>(q * static_cast<double>(count)) + 1;
+  std::uint64_t seen = 0;
+  for (unsigned i = 0; i < counts.size(); ++i)
+  {
+    seen += counts[i];
+    if (seen >= rank)
+    {
+      std::uint64_t upper = bucket_upper(i);
+      return upper < max ? upper : max;
+    }
+  }
+  return max;
+}
+
+double LatencyHistogram::Snapshot::mean() const
+{
+  return count ? static_cast<double>(sum) / static_cast<double>(count) : 0.0;
+}
+
+TcpClientMetrics::TcpClientMetrics()
+{
+  disconnected_since_.store(now_ns(), std::memory_order_relaxed);
+}
+
+std::uint64_t TcpClientMetrics::now_ns()
+{
+  return static_cast<std::uint64_t>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count());
+}
+
+void TcpClientMetrics::on_sent(std::size_t messages, std::size_t bytes)
+{
+  messages_sent_.fetch_add(messages, std::memory_order_relaxed);
+  bytes_sent_.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void TcpClientMetrics::on_received_bytes(std::size_t bytes)
+{
+  bytes_received_.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void TcpClientMetrics::on_received_message()
+{
+  messages_received_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TcpClientMetrics::on_queue_depth(std::size_t depth)
+{
+  std::uint64_t prev = write_queue_peak_.load(std::memory_order_relaxed);
+  while (depth > prev && !write_queue_peak_.compare_exchange_weak(prev, depth, std::memory_order_relaxed))
+  {
+  }
+}
+
+void TcpClientMetrics::on_reconnect()
+{
+  reconnects_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TcpClientMetrics::on_connected()
+{
+  std::uint64_t since = disconnected_since_.exchange(0, std::memory_order_relaxed);
+  if (since) disconnected_ns_.fetch_add(now_ns() - since, std::memory_order_relaxed);
+}
+
+void TcpClientMetrics::on_disconnected()
+{
+  std::uint64_t expected = 0;
+  disconnected_since_.compare_exchange_strong(expected, now_ns(), std::memory_order_relaxed);
+}
+
+void TcpClientMetrics::on_write_latency(std::uint64_t ns)
+{
+  write_latency_.record(ns);
+}
+
+void TcpClientMetrics::on_spilled(std::size_t bytes)
+{
+  spilled_messages_.fetch_add(1, std::memory_order_relaxed);
+  spilled_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void TcpClientMetrics::on_replayed(std::size_t messages, std::size_t bytes)
+{
+  spilled_messages_.fetch_sub(messages, std::memory_order_relaxed);
+  spilled_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+void TcpClientMetrics::on_spill_full()
+{
+  spill_full_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TcpClientMetrics::on_failover()
+{
+  failovers_.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::uint64_t TcpClientMetrics::bytes_sent() const
+{
+  return bytes_sent_.load(std::memory_order_relaxed);
+}
+
+std::uint64_t TcpClientMetrics::bytes_received() const
+{
+  return bytes_received_.load(std::memory_order_relaxed);
+}
+
+TcpClientMetrics::Snapshot TcpClientMetrics::snapshot() const
+{
+  Snapshot s;
+  s.bytes_sent = bytes_sent_.load(std::memory_order_relaxed);
+  s.messages_sent = messages_sent_.load(std::memory_order_relaxed);
+  s.bytes_received = bytes_received_.load(std::memory_order_relaxed);
+  s.messages_received = messages_received_.load(std::memory_order_relaxed);
+  s.write_queue_peak = write_queue_peak_.load(std::memory_order_relaxed);
+  s.reconnects = reconnects_.load(std::memory_order_relaxed);
+  s.disconnected_ns = disconnected_ns_.load(std::memory_order_relaxed);
+  std::uint64_t since = disconnected_since_.load(std::memory_order_relaxed);
+  s.connected = since == 0;
+  if (since) s.disconnected_ns += now_ns() - since;
+  s.spilled_messages = spilled_messages_.load(std::memory_order_relaxed);
+  s.spilled_bytes = spilled_bytes_.load(std::memory_order_relaxed);
+  s.spill_full = spill_full_.load(std::memory_order_relaxed);
+  s.failovers = failovers_.load(std::memory_order_relaxed);
+  s.write_latency = write_latency_.snapshot();
+  return s;
+}
@@ -0,0 +1,169 @@
+#include "network/tcp_client_pool.h"
+
+#include <limits>
+#include <stdexcept>
+
+struct TcpClientPool::State
+{
+  explicit State(std::size_t n) : healthy(new std::atomic<bool>[n]) {}
+
+  std::unique_ptr<std::atomic<bool>[]> healthy;  // 每个连接是否已连接
+  std::atomic<std::size_t> healthy_count{0};     // 已连接数
+  std::size_t total = 0;
+  StatusCallback on_status;
+  HealthCallback on_health;
+};
+
+TcpClientPool::TcpClientPool(asio::io_context& io, const std::string& host, const std::string& port,
+                             std::size_t size, DispatchPolicy policy) :
+  policy_(policy)
+{
+  init(std::vector<asio::io_context*>{&io}, host, port, size);
+}
+
+TcpClientPool::TcpClientPool(const std::vector<asio::io_context*>& contexts, const std::string& host,
+                             const std::string& port, std::size_t size, DispatchPolicy policy) :
+  policy_(policy)
+{
+  init(contexts, host, port, size);
+}
+
+TcpClientPool::~TcpClientPool()
+{
+  stop();
+}
+
+void TcpClientPool::init(const std::vector<asio::io_context*>& contexts, const std::string& host,
+                         const std::string& port, std::size_t size)
+{
+  if (contexts.empty()) throw std::invalid_argument("TcpClientPool: no io_context");
+  if (size == 0) size = 1;
+
+  state_ = std::make_shared<State>(size);
+  state_->total = size;
+  clients_.reserve(size);
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    state_->healthy[i].store(false);
+    clients_.push_back(std::make_shared<TcpClient>(*contexts[i % contexts.size()], host, port));
+  }
+}
+
+void TcpClientPool::set_message_callback(MessageCallback cb)
+{
+  for (auto& c : clients_) c->set_message_callback(cb);
+}
+
+void TcpClientPool::set_status_callback(StatusCallback cb)
+{
+  state_->on_status = std::move(cb);
+}
+
+void TcpClientPool::set_health_callback(HealthCallback cb)
+{
+  state_->on_health = std::move(cb);
+}
+
+void TcpClientPool::set_frame_codec_factory(CodecFactory factory)
+{
+  for (auto& c : clients_) c->set_frame_codec(factory ? factory() : nullptr);
+}
+
+void TcpClientPool::set_send_queue_limits(const TcpClient::SendQueueLimits& limits)
+{
+  for (auto& c : clients_) c->set_send_queue_limits(limits);
+}
+
+void TcpClientPool::start()
+{
+  for (std::size_t i = 0; i < clients_.size(); ++i)
+  {
+    std::shared_ptr<State> state = state_;
+    clients_[i]->set_status_callback([state, i](TcpClient::Status s, const std::string& info) {
+      bool up = s == TcpClient::Status::Connected;
+      if (state->healthy[i].exchange(up) != up)
+      {
+        std::size_t healthy = up ? state->healthy_count.fetch_add(1) + 1 : state->healthy_count.fetch_sub(1) - 1;
+        if (state->on_health) state->on_health(healthy, state->total);
+      }
+      if (state->on_status) state->on_status(i, s, info);
+    });
+    clients_[i]->start();
+  }
+}
+
+void TcpClientPool::stop()
+{
+  for (auto& c : clients_) c->stop();
+}
+
+bool TcpClientPool::send(const std::string& msg)
+{
+  return clients_[pick()]->send(msg);
+}
+
+bool TcpClientPool::send(const std::string& key, const std::string& msg)
+{
+  // 不跳过断开的连接，保证同一 key 始终走同一连接，重连后按原顺序发送
+  return clients_[std::hash<std::string>()(key) % clients_.size()]->send(msg);
+}
+
+bool TcpClientPool::send_frame(const std::string& payload)
+{
+  return clients_[pick()]->send_frame(payload);
+}
+
+std::size_t TcpClientPool::size() const
+{
+  return clients_.size();
+}
+
+std::size_t TcpClientPool::healthy_count() const
+{
+  return state_->healthy_count.load();
+}
+
+std::size_t TcpClientPool::queued_bytes() const
+{
+  std::size_t total = 0;
+  for (const auto& c : clients_) total += c->queued_bytes();
+  return total;
+}
+
+std::shared_ptr<TcpClient> TcpClientPool::client(std::size_t index) const
+{
+  return index < clients_.size() ? clients_[index] : nullptr;
+}
+
+std::size_t TcpClientPool::pick() const
+{
+  const std::size_t n = clients_.size();
+  // 没有健康连接时不做过滤，消息在各自的队列中等待重连
+  bool any_healthy = state_->healthy_count.load() > 0;
+
+  if (policy_ == DispatchPolicy::LeastQueuedBytes)
+  {
+    std::size_t best = 0;
+    std::size_t best_bytes = std::numeric_limits<std::size_t>::max();
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      if (any_healthy && !state_->healthy[i].load()) continue;
+      std::size_t bytes = clients_[i]->queued_bytes();
+      if (bytes < best_bytes)
+      {
+        best = i;
+        best_bytes = bytes;
+      }
+    }
+    return best;
+  }
+
+  // RoundRobin，以及 KeyHash 策略下不带 key 的发送
+  std::size_t start = next_.fetch_add(1);
+  for (std::size_t k = 0; k < n; ++k)
+  {
+    std::size_t i = (start + k) % n;
+    if (!any_healthy || state_->healthy[i].load()) return i;
+  }
+  return start % n;
+}
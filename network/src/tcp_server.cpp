@@ -0,0 +1,381 @@
+#include "network/tcp_server.h"
+
+#include <algorithm>
+#include <thread>
+
+#if !defined(_WIN32)
+#include <sys/socket.h>
+#endif
+
+#include "network/buffer_range.h"
+#include "network/flat_id_map.h"
+
+using asio::ip::tcp;
+
+namespace
+{
+// 单次聚合写最多携带的缓冲区数, 与 asio 内部 iovec 上限保持一致
+const std::size_t kMaxWriteBuffers = asio::detail::buffer_sequence_adapter_base::max_buffers;
+// 会话 ID 的高 16 位为工作线程序号 + 1，低 48 位为线程内递增序号
+const unsigned kWorkerShift = 48;
+
+#if defined(SO_REUSEPORT)
+using ReusePort = asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+#endif
+}  // namespace
+
+// 工作线程: 一个 io_context、（可选的）接受器和该线程上的全部会话
+struct TcpServer::Worker
+{
+  explicit Worker(std::size_t i) : index(i), io(1), guard(asio::make_work_guard(io)) {}
+
+  std::size_t index;
+  asio::io_context io;
+  asio::executor_work_guard<asio::io_context::executor_type> guard;
+  std::unique_ptr<tcp::acceptor> acceptor;  // 非 SO_REUSEPORT 模式下只有 0 号线程有接受器
+  FlatIdMap<SessionPtr> sessions;           // 只在本线程访问
+  std::uint64_t next_id = 0;
+  std::thread thread;
+};
+
+TcpServer::TcpServer(const Options& options) : options_(options) {}
+
+TcpServer::~TcpServer()
+{
+  stop();
+}
+
+void TcpServer::set_connection_callback(ConnectionCallback cb)
+{
+  on_connection_ = std::move(cb);
+}
+
+void TcpServer::set_message_callback(MessageCallback cb)
+{
+  on_message_ = std::move(cb);
+}
+
+void TcpServer::set_close_callback(CloseCallback cb)
+{
+  on_close_ = std::move(cb);
+}
+
+void TcpServer::set_frame_codec_factory(CodecFactory factory)
+{
+  codec_factory_ = std::move(factory);
+}
+
+bool TcpServer::start(std::error_code& ec)
+{
+  if (!workers_.empty()) return true;
+
+  tcp::endpoint endpoint(asio::ip::make_address(options_.address, ec), options_.port);
+  if (ec) return false;
+
+  std::size_t count = options_.workers > 0 ? options_.workers : std::thread::hardware_concurrency();
+  if (count == 0) count = 1;
+#if defined(SO_REUSEPORT)
+  reuse_port_ = options_.reuse_port && count > 1;
+#else
+  reuse_port_ = false;
+#endif
+
+  std::vector<std::unique_ptr<Worker>> workers;
+  for (std::size_t i = 0; i < count; ++i) workers.emplace_back(new Worker(i));
+
+  // 所有接受器绑定同一端口；端口为 0 时第一个接受器取得的端口供其余接受器使用
+  std::size_t acceptors = reuse_port_ ? count : 1;
+  for (std::size_t i = 0; i < acceptors; ++i)
+  {
+    std::unique_ptr<tcp::acceptor> acceptor(new tcp::acceptor(workers[i]->io));
+    acceptor->open(endpoint.protocol(), ec);
+    if (!ec) acceptor->set_option(asio::socket_base::reuse_address(true), ec);
+#if defined(SO_REUSEPORT)
+    if (!ec && reuse_port_) acceptor->set_option(ReusePort(true), ec);
+#endif
+    if (!ec) acceptor->bind(endpoint, ec);
+    if (!ec) acceptor->listen(options_.backlog, ec);
+    if (ec) return false;
+    if (i == 0) endpoint.port(acceptor->local_endpoint().port());
+    workers[i]->acceptor = std::move(acceptor);
+  }
+  port_ = endpoint.port();
+
+  workers_ = std::move(workers);
+  for (auto& w : workers_)
+  {
+    Worker* worker = w.get();
+    if (worker->acceptor) asio::post(worker->io, [this, worker] { start_accept(*worker); });
+    worker->thread = std::thread([worker] { worker->io.run(); });
+  }
+  ec.clear();
+  return true;
+}
+
+void TcpServer::stop()
+{
+  if (workers_.empty()) return;
+  for (auto& w : workers_)
+  {
+    Worker* worker = w.get();
+    asio::post(worker->io, [worker] {
+      std::error_code ignored;
+      if (worker->acceptor) worker->acceptor->close(ignored);
+      // 关闭时会从登记表中移除，先取出再逐个关闭
+      std::vector<SessionPtr> sessions;
+      worker->sessions.for_each([&sessions](std::uint64_t, SessionPtr& s) { sessions.push_back(s); });
+      for (auto& s : sessions) s->shutdown(asio::error::operation_aborted);
+    });
+    worker->guard.reset();
+  }
+  for (auto& w : workers_)
+  {
+    if (w->thread.joinable()) w->thread.join();
+  }
+  workers_.clear();
+}
+
+unsigned short TcpServer::port() const
+{
+  return port_;
+}
+
+std::size_t TcpServer::workers() const
+{
+  return workers_.size();
+}
+
+bool TcpServer::reuse_port() const
+{
+  return reuse_port_;
+}
+
+std::uint64_t TcpServer::accepted() const
+{
+  return accepted_.load(std::memory_order_relaxed);
+}
+
+std::size_t TcpServer::connections() const
+{
+  return connections_.load(std::memory_order_relaxed);
+}
+
+void TcpServer::start_accept(Worker& worker)
+{
+  if (reuse_port_)
+  {
+    // 每个线程接受自己的连接，会话直接建在本线程上
+    worker.acceptor->async_accept(worker.io, [this, &worker](std::error_code ec, tcp::socket socket) {
+      if (ec == asio::error::operation_aborted || !worker.acceptor->is_open()) return;
+      if (!ec) add_session(worker, std::move(socket));
+      start_accept(worker);
+    });
+    return;
+  }
+
+  // 单接受器: 套接字直接关联到目标线程的 io_context，会话在目标线程上创建
+  Worker& target = *workers_[next_worker_++ % workers_.size()];
+  worker.acceptor->async_accept(target.io, [this, &worker, &target](std::error_code ec, tcp::socket socket) {
+    if (ec == asio::error::operation_aborted || !worker.acceptor->is_open()) return;
+    if (!ec)
+    {
+      if (&target == &worker)
+      {
+        add_session(target, std::move(socket));
+      }
+      else
+      {
+        // asio::post 要求处理函数可复制，这里借 shared_ptr 转交套接字
+        auto moved = std::make_shared<tcp::socket>(std::move(socket));
+        asio::post(target.io, [this, &target, moved] { add_session(target, std::move(*moved)); });
+      }
+    }
+    start_accept(worker);
+  });
+}
+
+void TcpServer::add_session(Worker& worker, tcp::socket socket)
+{
+  accepted_.fetch_add(1, std::memory_order_relaxed);
+  std::error_code ec;
+  if (options_.no_delay) socket.set_option(tcp::no_delay(true), ec);
+  std::uint64_t id = (static_cast<std::uint64_t>(worker.index + 1) << kWorkerShift) | ++worker.next_id;
+  SessionPtr session(new Session(*this, worker.io, worker.index, id, std::move(socket)));
+  worker.sessions.insert(id, session);
+  connections_.fetch_add(1, std::memory_order_relaxed);
+  if (on_connection_) on_connection_(session);
+  session->start();
+}
+
+void TcpServer::remove_session(std::size_t worker, std::uint64_t id)
+{
+  if (workers_[worker]->sessions.erase(id)) connections_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+TcpServer::Session::Session(TcpServer& server, asio::io_context& io, std::size_t worker, std::uint64_t id,
+                            tcp::socket socket) :
+  server_(server),
+  io_(io),
+  worker_(worker),
+  id_(id),
+  socket_(std::move(socket)),
+  codec_(server.codec_factory_ ? server.codec_factory_() : nullptr),
+  handler_memory_(std::make_shared<HandlerMemory>()),
+  recv_buf_(server.options_.read_buffer_size)
+{
+  std::error_code ec;
+  remote_ = socket_.remote_endpoint(ec);
+}
+
+void TcpServer::Session::send(const std::string& data)
+{
+  send(std::string(data));
+}
+
+void TcpServer::Session::send(std::string&& data)
+{
+  if (io_.get_executor().running_in_this_thread())
+  {
+    enqueue(std::move(data));
+    return;
+  }
+  auto self = shared_from_this();
+  auto moved = std::make_shared<std::string>(std::move(data));
+  asio::post(io_, [self, moved] { self->enqueue(std::move(*moved)); });
+}
+
+bool TcpServer::Session::send_frame(const std::string& payload)
+{
+  if (!codec_)
+  {
+    send(payload);
+    return true;
+  }
+  std::string frame;
+  if (!codec_->encode(payload.data(), payload.size(), frame)) return false;
+  send(std::move(frame));
+  return true;
+}
+
+void TcpServer::Session::close()
+{
+  auto self = shared_from_this();
+  asio::dispatch(io_, [self] {
+    self->closing_ = true;
+    // 没有待写数据时立即关闭，否则由写完成处理函数在队列写空后关闭
+    if (!self->writing_) self->shutdown(std::error_code());
+  });
+}
+
+void TcpServer::Session::start()
+{
+  do_read();
+}
+
+void TcpServer::Session::do_read()
+{
+  if (closed_) return;
+  auto self = shared_from_this();
+  auto on_read = [this, self](std::error_code ec, std::size_t length) {
+    if (closed_) return;
+    if (ec)
+    {
+      shutdown(ec);
+      return;
+    }
+    recv_buf_.commit(length);
+    if (!dispatch_received())
+    {
+      shutdown(asio::error::invalid_argument);
+      return;
+    }
+    do_read();
+  };
+  socket_.async_read_some(recv_buf_.prepare(), asio::bind_allocator(handler_allocator(), on_read));
+}
+
+bool TcpServer::Session::dispatch_received()
+{
+  const MessageCallback& cb = server_.on_message_;
+  if (!codec_)
+  {
+    // 未分帧: 原样交付本次读取到的数据
+    asio::const_buffer data(recv_buf_.data(), recv_buf_.size());
+    recv_buf_.consume(data.size());
+    if (cb) cb(shared_from_this(), data);
+    return true;
+  }
+
+  std::error_code ec;
+  while (!recv_buf_.empty() && !closed_)
+  {
+    const char* frame = nullptr;
+    std::size_t frame_size = 0;
+    std::size_t consumed = codec_->decode(recv_buf_.data(), recv_buf_.size(), frame, frame_size, ec);
+    if (ec) return false;
+    if (consumed == 0) break;
+    recv_buf_.consume(consumed);
+    if (cb) cb(shared_from_this(), asio::const_buffer(frame, frame_size));
+  }
+  return true;
+}
+
+void TcpServer::Session::enqueue(std::string&& data)
+{
+  if (closed_ || closing_ || data.empty()) return;
+  write_msgs_.push_back(std::move(data));
+  do_write();
+}
+
+void TcpServer::Session::do_write()
+{
+  if (writing_ || closed_ || write_msgs_.empty()) return;
+
+  // 把队列中的消息聚合为一次 scatter-gather 写
+  // 先整批移入 writing_msgs_ 再取缓冲区地址，移入过程中 vector 扩容不会使已取的缓冲区失效
+  writing_ = true;
+  writing_msgs_.clear();
+  write_bufs_.clear();
+  std::size_t count = std::min(write_msgs_.size(), kMaxWriteBuffers);
+  writing_msgs_.reserve(count);
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    writing_msgs_.push_back(std::move(write_msgs_.front()));
+    write_msgs_.pop_front();
+  }
+  for (const auto& m : writing_msgs_)
+  {
+    write_bufs_.push_back(asio::buffer(m));
+  }
+
+  auto self = shared_from_this();
+  auto on_write = [this, self](std::error_code ec, std::size_t) {
+    writing_ = false;
+    if (closed_) return;
+    if (ec)
+    {
+      shutdown(ec);
+      return;
+    }
+    if (closing_ && write_msgs_.empty())
+    {
+      shutdown(std::error_code());
+      return;
+    }
+    do_write();
+  };
+  asio::async_write(socket_, BufferRange(write_bufs_), asio::bind_allocator(handler_allocator(), on_write));
+}
+
+void TcpServer::Session::shutdown(const std::error_code& ec)
+{
+  if (closed_) return;
+  closed_ = true;
+  std::error_code ignored;
+  socket_.shutdown(tcp::socket::shutdown_both, ignored);
+  socket_.close(ignored);
+  write_msgs_.clear();
+  auto self = shared_from_this();
+  if (server_.on_close_) server_.on_close_(self, ec);
+  server_.remove_session(worker_, id_);
+}
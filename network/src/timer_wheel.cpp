@@ -0,0 +1,208 @@
+#include "network/timer_wheel.h"
+
+#include <vector>
+
+namespace
+{
+const std::chrono::milliseconds kResolution(10);
+}  // namespace
+
+asio::io_context::id TimerWheel::id;
+
+TimerWheel::Timer::~Timer()
+{
+  if (wheel_) wheel_->cancel(*this);
+}
+
+bool TimerWheel::Timer::armed() const
+{
+  return wheel_ != nullptr;
+}
+
+TimerWheel::TimerWheel(asio::io_context& io) :
+  asio::io_context::service(io), driver_(io), epoch_(Clock::now())
+{
+}
+
+TimerWheel::~TimerWheel()
+{
+  shutdown();
+}
+
+TimerWheel& TimerWheel::get(asio::io_context& io)
+{
+  return asio::use_service<TimerWheel>(io);
+}
+
+TimerWheel::Clock::duration TimerWheel::resolution()
+{
+  return kResolution;
+}
+
+std::size_t TimerWheel::size() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return count_;
+}
+
+void TimerWheel::arm(Timer& timer, Clock::duration delay, Callback callback)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (timer.wheel_) unlink(timer);
+
+  std::uint64_t now = tick_of(Clock::now());
+  // 空闲期间没有推进刻度，直接跳到当前时间
+  if (count_ == 0 && now > current_) current_ = now;
+
+  // 向上取整，至少在下一个刻度到期
+  std::uint64_t ticks = static_cast<std::uint64_t>((delay + kResolution - Clock::duration(1)) / kResolution);
+  timer.expiry_ = std::max(now, current_) + std::max<std::uint64_t>(ticks, 1);
+  timer.callback_ = std::move(callback);
+  link(timer);
+  start_driver();
+}
+
+void TimerWheel::cancel(Timer& timer)
+{
+  Callback dropped;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (timer.wheel_ != this) return;
+    unlink(timer);
+    dropped.swap(timer.callback_);
+  }
+  // 回调可能持有对象的最后一个引用，在锁外析构
+}
+
+void TimerWheel::shutdown()
+{
+  std::vector<Callback> dropped;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (unsigned level = 0; level < kLevels; ++level)
+    {
+      for (unsigned slot = 0; slot < kSlots; ++slot)
+      {
+        while (Timer* t = wheel_[level][slot].head)
+        {
+          unlink(*t);
+          dropped.push_back(std::move(t->callback_));
+        }
+      }
+    }
+  }
+  std::error_code ec;
+  driver_.cancel(ec);
+}
+
+void TimerWheel::link(Timer& timer)
+{
+  // 按距离到期的刻度数选择层：第 n 层的槽跨度为 256^n 个刻度
+  std::uint64_t delta = timer.expiry_ - current_;
+  unsigned level = 0;
+  while (level + 1 < kLevels && delta >= (std::uint64_t(1) << (kSlotBits * (level + 1)))) ++level;
+  unsigned index = static_cast<unsigned>((timer.expiry_ >> (kSlotBits * level)) & (kSlots - 1));
+
+  Slot& slot = wheel_[level][index];
+  timer.prev_ = nullptr;
+  timer.next_ = slot.head;
+  if (slot.head) slot.head->prev_ = &timer;
+  slot.head = &timer;
+  timer.wheel_ = this;
+  ++count_;
+}
+
+void TimerWheel::unlink(Timer& timer)
+{
+  if (timer.prev_)
+  {
+    timer.prev_->next_ = timer.next_;
+  }
+  else
+  {
+    // 表头: 需要找到所在的槽
+    for (unsigned level = 0; level < kLevels; ++level)
+    {
+      unsigned index = static_cast<unsigned>((timer.expiry_ >> (kSlotBits * level)) & (kSlots - 1));
+      if (wheel_[level][index].head == &timer)
+      {
+        wheel_[level][index].head = timer.next_;
+        break;
+      }
+    }
+  }
+  if (timer.next_) timer.next_->prev_ = timer.prev_;
+  timer.prev_ = timer.next_ = nullptr;
+  timer.wheel_ = nullptr;
+  --count_;
+}
+
+void TimerWheel::cascade(unsigned level)
+{
+  // 把高层当前槽中的定时器重新分配到更低的层
+  unsigned index = static_cast<unsigned>((current_ >> (kSlotBits * level)) & (kSlots - 1));
+  Timer* t = wheel_[level][index].head;
+  wheel_[level][index].head = nullptr;
+  while (t)
+  {
+    Timer* next = t->next_;
+    --count_;
+    link(*t);
+    t = next;
+  }
+}
+
+std::uint64_t TimerWheel::tick_of(Clock::time_point t) const
+{
+  return t <= epoch_ ? 0 : static_cast<std::uint64_t>((t - epoch_) / kResolution);
+}
+
+void TimerWheel::start_driver()
+{
+  if (driver_running_ || count_ == 0) return;
+  driver_running_ = true;
+  driver_.expires_at(epoch_ + kResolution * static_cast<Clock::rep>(current_ + 1));
+  driver_.async_wait([this](std::error_code ec) {
+    if (ec) return;
+    on_tick();
+  });
+}
+
+void TimerWheel::on_tick()
+{
+  std::vector<Callback> expired;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    driver_running_ = false;
+    std::uint64_t now = tick_of(Clock::now());
+    while (current_ < now && count_ > 0)
+    {
+      ++current_;
+      // 每当低层转满一圈，把上一层对应槽中的定时器向下分配
+      for (unsigned level = 1; level < kLevels; ++level)
+      {
+        if ((current_ & ((std::uint64_t(1) << (kSlotBits * level)) - 1)) != 0) break;
+        cascade(level);
+      }
+      Slot& slot = wheel_[0][current_ & (kSlots - 1)];
+      while (Timer* t = slot.head)
+      {
+        unlink(*t);
+        expired.push_back(std::move(t->callback_));
+      }
+    }
+    if (count_ == 0 && now > current_) current_ = now;
+    start_driver();
+  }
+
+  for (auto& cb : expired)
+  {
+    try
+    {
+      if (cb) cb();
+    }
+    catch (...)
+    {
+    }
+  }
+}
@@ -0,0 +1,353 @@
+#include "network/udp_batch_socket.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__linux__)
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <cerrno>
+#define NETWORK_HAS_MMSG 1
+// 旧版本 glibc 头文件中没有以下定义，取值与内核 include/uapi/linux/udp.h 一致
+#if !defined(UDP_SEGMENT)
+#define UDP_SEGMENT 103
+#endif
+#if !defined(UDP_GRO)
+#define UDP_GRO 104
+#endif
+#endif
+
+using asio::ip::udp;
+
+namespace
+{
+// 一条分段消息最多的段数（内核 UDP_MAX_SEGMENTS）和最大负载（IPv4 UDP 负载上限）
+const std::size_t kMaxGsoSegments = 64;
+const std::size_t kMaxGsoPayload = 65507;
+
+// 长度为 size 的数据按 segment 切分后的数据报数，空数据报也算一个
+std::size_t segment_count(std::size_t size, std::size_t segment)
+{
+  if (segment == 0 || size == 0) return 1;
+  return (size + segment - 1) / segment;
+}
+}  // namespace
+
+#if defined(NETWORK_HAS_MMSG)
+// recvmmsg / sendmmsg 使用的消息数组，iovec 指向 recv_buf_ / send_buf_ 中的槽，msg_name 指向端点的存储，
+// 控制消息区用于接收 UDP_GRO 的分段长度和发送 UDP_SEGMENT
+struct UdpBatchSocket::Native
+{
+  static const std::size_t kRecvControl = CMSG_SPACE(sizeof(int));
+  static const std::size_t kSendControl = CMSG_SPACE(sizeof(std::uint16_t));
+
+  explicit Native(std::size_t n) :
+    recv_msgs(n),
+    recv_iov(n),
+    recv_control(n * kRecvControl),
+    send_msgs(n),
+    send_iov(n),
+    send_control(n * kSendControl)
+  {
+  }
+
+  std::vector<mmsghdr> recv_msgs;
+  std::vector<iovec> recv_iov;
+  std::vector<char> recv_control;
+  std::vector<mmsghdr> send_msgs;
+  std::vector<iovec> send_iov;
+  std::vector<char> send_control;
+};
+#else
+struct UdpBatchSocket::Native
+{
+  explicit Native(std::size_t) {}
+};
+#endif
+
+UdpBatchSocket::UdpBatchSocket(asio::io_context& io, const udp::endpoint& local) :
+  UdpBatchSocket(io, local, Options())
+{
+}
+
+UdpBatchSocket::UdpBatchSocket(asio::io_context& io, const udp::endpoint& local, const Options& options) :
+  socket_(io, local), options_(options)
+{
+  options_.batch_size = std::max<std::size_t>(options_.batch_size, 1);
+  options_.max_datagram_size = std::max<std::size_t>(options_.max_datagram_size, 1);
+  const std::size_t n = options_.batch_size;
+  native_.reset(new Native(n));
+  recv_buf_.resize(n * options_.max_datagram_size);
+  datagrams_.resize(n);
+  send_buf_.resize(n * options_.max_datagram_size);
+  send_size_.resize(n);
+  send_seg_.resize(n);
+  send_to_.resize(n);
+
+#if defined(NETWORK_HAS_MMSG)
+  // 能读取 UDP_SEGMENT 说明内核支持发送分段卸载（Linux 4.18+），UDP_GRO 需要 Linux 5.0+
+  int fd = socket_.native_handle();
+  int value = 0;
+  socklen_t len = sizeof(value);
+  gso_ = ::getsockopt(fd, SOL_UDP, UDP_SEGMENT, &value, &len) == 0;
+  int on = 1;
+  gro_ = options_.gro && ::setsockopt(fd, SOL_UDP, UDP_GRO, &on, sizeof(on)) == 0;
+
+  // 接收槽与地址存储固定不变，提前填好，每次调用只需重置长度和标志
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    native_->recv_iov[i].iov_base = &recv_buf_[i * options_.max_datagram_size];
+    native_->recv_iov[i].iov_len = options_.max_datagram_size;
+    std::memset(&native_->recv_msgs[i], 0, sizeof(mmsghdr));
+    native_->recv_msgs[i].msg_hdr.msg_name = datagrams_[i].remote.data();
+    native_->recv_msgs[i].msg_hdr.msg_iov = &native_->recv_iov[i];
+    native_->recv_msgs[i].msg_hdr.msg_iovlen = 1;
+    if (gro_) native_->recv_msgs[i].msg_hdr.msg_control = &native_->recv_control[i * Native::kRecvControl];
+
+    native_->send_iov[i].iov_base = &send_buf_[i * options_.max_datagram_size];
+    std::memset(&native_->send_msgs[i], 0, sizeof(mmsghdr));
+    native_->send_msgs[i].msg_hdr.msg_iov = &native_->send_iov[i];
+    native_->send_msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+#else
+  socket_.non_blocking(true);
+#endif
+}
+
+UdpBatchSocket::~UdpBatchSocket() = default;
+
+void UdpBatchSocket::start(ReceiveHandler handler)
+{
+  handler_ = std::move(handler);
+  wait_readable();
+}
+
+void UdpBatchSocket::stop()
+{
+  stopped_ = true;
+  send_count_ = send_done_ = 0;
+  std::error_code ec;
+  socket_.close(ec);
+}
+
+bool UdpBatchSocket::send_to(asio::const_buffer data, const udp::endpoint& remote)
+{
+  if (enqueue(data, 0, remote)) return true;
+  ++stats_.dropped;
+  return false;
+}
+
+bool UdpBatchSocket::send_segments(asio::const_buffer data, std::size_t segment_size, const udp::endpoint& remote)
+{
+  if (segment_size == 0 || segment_size >= data.size()) return send_to(data, remote);
+  const char* p = static_cast<const char*>(data.data());
+  std::size_t size = data.size();
+  // 每条消息的长度取段长的整数倍；不支持分段卸载时每段单独一条消息
+  std::size_t chunk = segment_size;
+  if (gso_)
+  {
+    std::size_t limit = std::min(std::min(options_.max_datagram_size, kMaxGsoPayload), kMaxGsoSegments * segment_size);
+    chunk = std::max<std::size_t>(limit / segment_size, 1) * segment_size;
+  }
+  for (std::size_t offset = 0; offset < size; offset += chunk)
+  {
+    std::size_t n = std::min(chunk, size - offset);
+    if (!enqueue(asio::buffer(p + offset, n), n > segment_size ? segment_size : 0, remote))
+    {
+      stats_.dropped += segment_count(size - offset, segment_size);
+      return false;
+    }
+  }
+  return true;
+}
+
+bool UdpBatchSocket::enqueue(asio::const_buffer data, std::size_t segment_size, const udp::endpoint& remote)
+{
+  if (stopped_ || data.size() > options_.max_datagram_size) return false;
+  if (send_count_ == options_.batch_size)
+  {
+    // 发送区满: 先发出已排队的数据报，内核发送缓冲区也满时只能丢弃
+    if (!waiting_write_) flush();
+    if (send_count_ == options_.batch_size) return false;
+  }
+  std::size_t i = send_count_++;
+  std::memcpy(&send_buf_[i * options_.max_datagram_size], data.data(), data.size());
+  send_size_[i] = data.size();
+  send_seg_[i] = segment_size;
+  send_to_[i] = remote;
+  return true;
+}
+
+std::size_t UdpBatchSocket::flush()
+{
+  if (waiting_write_ || stopped_) return 0;  // 等待可写期间由可写回调继续发送
+  std::size_t sent = 0;
+#if defined(NETWORK_HAS_MMSG)
+  for (std::size_t i = send_done_; i < send_count_; ++i)
+  {
+    msghdr& hdr = native_->send_msgs[i].msg_hdr;
+    native_->send_iov[i].iov_len = send_size_[i];
+    hdr.msg_name = send_to_[i].data();
+    hdr.msg_namelen = static_cast<socklen_t>(send_to_[i].size());
+    if (send_seg_[i] == 0)
+    {
+      hdr.msg_control = nullptr;
+      hdr.msg_controllen = 0;
+      continue;
+    }
+    // 分段消息: 附带 UDP_SEGMENT 控制消息，由内核按段长切分
+    hdr.msg_control = &native_->send_control[i * Native::kSendControl];
+    hdr.msg_controllen = Native::kSendControl;
+    cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr);
+    cmsg->cmsg_level = SOL_UDP;
+    cmsg->cmsg_type = UDP_SEGMENT;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(std::uint16_t));
+    std::uint16_t segment = static_cast<std::uint16_t>(send_seg_[i]);
+    std::memcpy(CMSG_DATA(cmsg), &segment, sizeof(segment));
+  }
+  while (send_done_ < send_count_)
+  {
+    int n = ::sendmmsg(socket_.native_handle(), &native_->send_msgs[send_done_],
+                       static_cast<unsigned int>(send_count_ - send_done_), MSG_DONTWAIT);
+    ++stats_.send_calls;
+    if (n < 0)
+    {
+      if (errno == EINTR) continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK)
+      {
+        stats_.sent += sent;
+        wait_writable();
+        return sent;
+      }
+      // 第一条消息发送失败（例如目标不可达），跳过它继续发送其余的
+      stats_.dropped += segment_count(send_size_[send_done_], send_seg_[send_done_]);
+      ++send_done_;
+      continue;
+    }
+    for (int k = 0; k < n; ++k, ++send_done_) sent += segment_count(send_size_[send_done_], send_seg_[send_done_]);
+  }
+#else
+  while (send_done_ < send_count_)
+  {
+    std::size_t i = send_done_;
+    std::error_code ec;
+    socket_.send_to(asio::buffer(&send_buf_[i * options_.max_datagram_size], send_size_[i]), send_to_[i], 0, ec);
+    ++stats_.send_calls;
+    if (ec == asio::error::would_block || ec == asio::error::try_again)
+    {
+      stats_.sent += sent;
+      wait_writable();
+      return sent;
+    }
+    if (ec)
+      ++stats_.dropped;
+    else
+      ++sent;
+    ++send_done_;
+  }
+#endif
+  stats_.sent += sent;
+  send_count_ = send_done_ = 0;
+  return sent;
+}
+
+void UdpBatchSocket::wait_readable()
+{
+  socket_.async_wait(udp::socket::wait_read, [this](const std::error_code& ec) {
+    if (!ec && !stopped_) receive_batch();
+  });
+}
+
+void UdpBatchSocket::receive_batch()
+{
+  std::size_t n = receive_some();
+  if (n > 0)
+  {
+    handler_(datagrams_.data(), n);
+    flush();
+  }
+  if (stopped_) return;
+  if (n == options_.batch_size)
+  {
+    // 一批取满，队列中可能还有数据: 投递下一轮而不是原地循环，让同一线程上的其他操作有机会执行
+    asio::post(socket_.get_executor(), [this] {
+      if (!stopped_) receive_batch();
+    });
+  }
+  else
+  {
+    wait_readable();
+  }
+}
+
+std::size_t UdpBatchSocket::receive_some()
+{
+  const std::size_t max = options_.max_datagram_size;
+#if defined(NETWORK_HAS_MMSG)
+  for (std::size_t i = 0; i < options_.batch_size; ++i)
+  {
+    native_->recv_msgs[i].msg_hdr.msg_namelen = static_cast<socklen_t>(datagrams_[i].remote.capacity());
+    native_->recv_msgs[i].msg_hdr.msg_flags = 0;
+    if (gro_) native_->recv_msgs[i].msg_hdr.msg_controllen = Native::kRecvControl;
+  }
+  int n;
+  do
+  {
+    n = ::recvmmsg(socket_.native_handle(), native_->recv_msgs.data(), static_cast<unsigned int>(options_.batch_size),
+                   MSG_DONTWAIT, nullptr);
+    ++stats_.receive_calls;
+  } while (n < 0 && errno == EINTR);
+  if (n <= 0) return 0;  // EAGAIN，或 ICMP 错误等（已被本次调用取走）
+
+  for (int i = 0; i < n; ++i)
+  {
+    const mmsghdr& msg = native_->recv_msgs[i];
+    Datagram& d = datagrams_[i];
+    d.data = asio::buffer(&recv_buf_[i * max], std::min<std::size_t>(msg.msg_len, max));
+    d.truncated = (msg.msg_hdr.msg_flags & MSG_TRUNC) != 0;
+    d.remote.resize(msg.msg_hdr.msg_namelen);
+    d.segment_size = d.data.size();
+    if (gro_)
+    {
+      // 合并后的超级数据报带有 UDP_GRO 控制消息，内容为合并前每个数据报的长度
+      msghdr* hdr = const_cast<msghdr*>(&msg.msg_hdr);
+      for (cmsghdr* cmsg = CMSG_FIRSTHDR(hdr); cmsg; cmsg = CMSG_NXTHDR(hdr, cmsg))
+      {
+        if (cmsg->cmsg_level != SOL_UDP || cmsg->cmsg_type != UDP_GRO) continue;
+        int segment = 0;
+        std::memcpy(&segment, CMSG_DATA(cmsg), sizeof(segment));
+        if (segment > 0) d.segment_size = static_cast<std::size_t>(segment);
+      }
+    }
+    stats_.received += segment_count(d.data.size(), d.segment_size);
+  }
+  return static_cast<std::size_t>(n);
+#else
+  std::size_t n = 0;
+  while (n < options_.batch_size)
+  {
+    std::error_code ec;
+    std::size_t len = socket_.receive_from(asio::buffer(&recv_buf_[n * max], max), datagrams_[n].remote, 0, ec);
+    ++stats_.receive_calls;
+    if (ec) break;
+    datagrams_[n].data = asio::buffer(&recv_buf_[n * max], len);
+    datagrams_[n].segment_size = len;
+    datagrams_[n].truncated = false;
+    ++n;
+  }
+  stats_.received += n;
+  return n;
+#endif
+}
+
+void UdpBatchSocket::wait_writable()
+{
+  waiting_write_ = true;
+  socket_.async_wait(udp::socket::wait_write, [this](const std::error_code& ec) {
+    waiting_write_ = false;
+    if (!ec && !stopped_) flush();
+  });
+}
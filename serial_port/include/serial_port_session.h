@@ -1,5 +1,5 @@
 /*
- @description: 串口通讯类, 依赖asio库(头文件版).
+ @description: 串口通讯类, 依赖asio库(头文件版)和 network/handler_allocator.h(仅头文件).
  @version: v0.9.0
  @author: abin
 
@@ -46,10 +46,13 @@ int main()
 #include <thread>
 #include <vector>
 
+#include "network/handler_allocator.h"
+
 class SerialPortSession : public std::enable_shared_from_this<SerialPortSession>
 {
  public:
   using ReceiveCallback = std::function<void(const std::string&)>;
+  using ReceiveViewCallback = std::function<void(asio::const_buffer)>;  // 零拷贝接收回调, 视图仅在回调期间有效
   using ErrorCallback = std::function<void(const std::string&)>;
 
   // 禁用拷贝和赋值
@@ -66,6 +69,10 @@ class SerialPortSession : public std::enable_shared_from_this<SerialPortSession>
   void send(std::string data);
 
   void set_receive_callback(ReceiveCallback cb);
+  void set_receive_view_callback(ReceiveViewCallback cb);
+
+  // 在接收视图回调内调用: 接管当前读缓冲区, 使视图在返回值存活期间保持有效, 后续读取换用新缓冲区
+  std::shared_ptr<const std::vector<char>> retain_received();
   void set_error_callback(ErrorCallback cb);
 
   bool is_open() const;
@@ -89,7 +96,10 @@ class SerialPortSession : public std::enable_shared_from_this<SerialPortSession>
   std::string port_name_;
   unsigned int baud_rate_{9600};
 
-  std::array<char, 1024> read_buffer_;
+  std::vector<char> read_buffer_;
+  std::shared_ptr<const std::vector<char>> retained_;
+  std::shared_ptr<HandlerMemory> handler_memory_;  // 读写完成处理函数的内存池
   ReceiveCallback receive_callback_;
+  ReceiveViewCallback receive_view_callback_;
   ErrorCallback error_callback_;
 };
@@ -16,7 +16,9 @@ SerialPortSession::SerialPortSession(std::string port_name, unsigned int baud_ra
   strand_(asio::make_strand(io_)),
   serial_(io_),
   port_name_(std::move(port_name)),
-  baud_rate_(baud_rate)
+  baud_rate_(baud_rate),
+  read_buffer_(1024),
+  handler_memory_(std::make_shared<HandlerMemory>())
 {
 }
 
@@ -169,15 +171,16 @@ void SerialPortSession::send(std::string data)
   auto self = shared_from_this();
   auto data_ptr = std::make_shared<std::string>(std::move(data));  // 使用 shared_ptr 确保数据在异步操作期间有效
 
-  asio::post(strand_, [self, data_ptr]() {
+  HandlerAllocator<void> alloc(handler_memory_);
+  asio::post(strand_, asio::bind_allocator(alloc, [self, data_ptr, alloc]() {
     if (!self->serial_.is_open()) return;
 
+    auto on_write = [self, data_ptr](const asio::error_code& ec, std::size_t) {
+      if (ec && ec != asio::error::operation_aborted) self->report_error("Send error: " + ec.message());
+    };
     asio::async_write(self->serial_, asio::buffer(*data_ptr),
-                      asio::bind_executor(self->strand_, [self, data_ptr](const asio::error_code& ec, std::size_t) {
-                        if (ec && ec != asio::error::operation_aborted)
-                          self->report_error("Send error: " + ec.message());
-                      }));
-  });
+                      asio::bind_executor(self->strand_, asio::bind_allocator(alloc, on_write)));
+  }));
 }
 
 void SerialPortSession::set_receive_callback(ReceiveCallback cb)
@@ -185,6 +188,22 @@ void SerialPortSession::set_receive_callback(ReceiveCallback cb)
   receive_callback_ = std::move(cb);
 }
 
+void SerialPortSession::set_receive_view_callback(ReceiveViewCallback cb)
+{
+  receive_view_callback_ = std::move(cb);
+}
+
+std::shared_ptr<const std::vector<char>> SerialPortSession::retain_received()
+{
+  if (!retained_)
+  {
+    std::vector<char> fresh(read_buffer_.size());
+    retained_ = std::make_shared<const std::vector<char>>(std::move(read_buffer_));
+    read_buffer_.swap(fresh);
+  }
+  return retained_;
+}
+
 void SerialPortSession::set_error_callback(ErrorCallback cb)
 {
   error_callback_ = std::move(cb);
@@ -198,20 +217,23 @@ bool SerialPortSession::is_open() const
 void SerialPortSession::start_async_read()
 {
   auto self = shared_from_this();
-  serial_.async_read_some(
-    asio::buffer(read_buffer_),
-    asio::bind_executor(strand_, [self](const asio::error_code& ec, std::size_t bytes_transferred) {
-      if (!ec)
-      {
-        std::string data(self->read_buffer_.data(), bytes_transferred);
-        if (self->receive_callback_) self->receive_callback_(data);
-        self->start_async_read();  // 继续监听
-      }
-      else if (ec != asio::error::operation_aborted)
-      {
-        self->report_error("Read error: " + ec.message());
-      }
-    }));
+  auto on_read = [self](const asio::error_code& ec, std::size_t bytes_transferred) {
+    if (!ec)
+    {
+      const char* data = self->read_buffer_.data();
+      if (self->receive_view_callback_) self->receive_view_callback_(asio::const_buffer(data, bytes_transferred));
+      if (self->receive_callback_) self->receive_callback_(std::string(data, bytes_transferred));
+      self->retained_.reset();
+      self->start_async_read();  // 继续监听
+    }
+    else if (ec != asio::error::operation_aborted)
+    {
+      self->report_error("Read error: " + ec.message());
+    }
+  };
+  HandlerAllocator<void> alloc(handler_memory_);
+  serial_.async_read_some(asio::buffer(read_buffer_),
+                          asio::bind_executor(strand_, asio::bind_allocator(alloc, on_read)));
 }
 
 void SerialPortSession::report_info(const std::string& msg)
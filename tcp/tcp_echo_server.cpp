@@ -0,0 +1,110 @@
+/*
+  回环回显服务器，配合 tcp_loadgen 在单机上做压测
+  收到什么原样写回，不解析帧；每个工作线程一个 io_context，新连接轮流分配给各线程
+  用法: tcp_echo_server [port=8080] [threads=硬件线程数]
+*/
+
+#include <asio.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using asio::ip::tcp;
+
+// 回显会话: 读到数据后整段写回，写完再读，同一时刻只有一个操作在途
+class EchoSession : public std::enable_shared_from_this<EchoSession>
+{
+ public:
+  explicit EchoSession(tcp::socket socket) : socket_(std::move(socket)) {}
+
+  void start()
+  {
+    std::error_code ec;
+    socket_.set_option(tcp::no_delay(true), ec);
+    do_read();
+  }
+
+ private:
+  void do_read()
+  {
+    auto self = shared_from_this();
+    socket_.async_read_some(asio::buffer(buf_), [this, self](std::error_code ec, std::size_t n) {
+      if (!ec) do_write(n);
+    });
+  }
+
+  void do_write(std::size_t n)
+  {
+    auto self = shared_from_this();
+    asio::async_write(socket_, asio::buffer(buf_, n), [this, self](std::error_code ec, std::size_t) {
+      if (!ec) do_read();
+    });
+  }
+
+  tcp::socket socket_;
+  char buf_[64 * 1024];
+};
+
+// 监听在主 io_context 上，已接受的连接交给工作线程的 io_context
+class EchoServer
+{
+ public:
+  EchoServer(asio::io_context& io, unsigned short port, std::vector<std::unique_ptr<asio::io_context>>& workers) :
+    acceptor_(io, tcp::endpoint(tcp::v4(), port)), workers_(workers)
+  {
+    start_accept();
+  }
+
+ private:
+  void start_accept()
+  {
+    asio::io_context& target = *workers_[next_++ % workers_.size()];
+    acceptor_.async_accept(target, [this](std::error_code ec, tcp::socket socket) {
+      if (!ec) std::make_shared<EchoSession>(std::move(socket))->start();
+      start_accept();
+    });
+  }
+
+  tcp::acceptor acceptor_;
+  std::vector<std::unique_ptr<asio::io_context>>& workers_;
+  std::size_t next_ = 0;
+};
+
+int main(int argc, char* argv[])
+{
+  unsigned short port = static_cast<unsigned short>(argc > 1 ? std::atoi(argv[1]) : 8080);
+  unsigned threads = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : std::thread::hardware_concurrency();
+  if (threads == 0) threads = 1;
+
+  try
+  {
+    asio::io_context accept_io;
+    std::vector<std::unique_ptr<asio::io_context>> workers;
+    std::vector<asio::executor_work_guard<asio::io_context::executor_type>> guards;
+    for (unsigned i = 0; i < threads; ++i)
+    {
+      workers.emplace_back(new asio::io_context(1));
+      guards.push_back(asio::make_work_guard(*workers.back()));
+    }
+
+    EchoServer server(accept_io, port, workers);
+    std::cout << "echo server listening on " << port << " with " << threads << " worker thread(s)\n";
+
+    std::vector<std::thread> pool;
+    for (auto& w : workers)
+    {
+      asio::io_context* io = w.get();
+      pool.emplace_back([io] { io->run(); });
+    }
+    accept_io.run();
+    for (auto& t : pool) t.join();
+  }
+  catch (std::exception& e)
+  {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
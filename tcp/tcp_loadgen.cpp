@@ -0,0 +1,516 @@
+/*
+  基于 TcpClient 的压测工具，配合 tcp_echo_server 使用
+  - N 个客户端轮流分配到 M 个线程，每个线程一个 io_context
+  - 每条消息为 u32 长度前缀帧，负载开头 8 字节为发送时间戳，回显回来后计算往返延迟
+  - 开环模式（指定 --rate）: 按固定间隔计划发送时间，时间戳记录"计划"发送时间而不是实际发送时间，
+    服务器变慢时排队等待的时间也计入延迟，避免协调遗漏（coordinated omission）
+  - 闭环模式（--rate 0）: 每个客户端保持 --pipeline 条在途消息，收到回复立即发送下一条，测最大吞吐
+  - 消息大小固定为 --size，或在 [--size, --size-max] 内均匀分布
+  - 每秒打印一次吞吐，结束时打印吞吐和 p50 / p99 / p99.9 / max 延迟（预热阶段的样本不计入）
+  - 建连模式（--mode connect）: 配合 daytime 式短连接服务器（如 tcp_server_async）测接受速率，
+    每个客户端循环 "异步连接 - 读到 EOF - 关闭"，延迟为从发起连接到读到 EOF 的时间，
+    --rate / --pipeline / --size 在此模式下不使用
+  用法:
+    tcp_loadgen [--host 127.0.0.1] [--port 8080] [--mode echo] [--clients 64] [--threads 4] [--rate 0]
+                [--pipeline 1] [--size 64] [--size-max 0] [--duration 10] [--warmup 1]
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "network/tcp_client.h"
+
+namespace
+{
+const std::size_t kStampSize = 8;  // 负载开头的时间戳字节数
+
+struct Config
+{
+  std::string host = "127.0.0.1";
+  std::string port = "8080";
+  bool connect_mode = false;  // --mode connect: 短连接建连压测
+  int clients = 64;
+  int threads = 4;
+  double rate = 0;       // 总目标速率（消息/秒），0 表示闭环
+  int pipeline = 1;      // 闭环模式下每个客户端的在途消息数
+  std::size_t size = 64;      // 负载大小（字节）
+  std::size_t size_max = 0;   // 大于 size 时在 [size, size_max] 内均匀分布
+  double duration = 10;  // 统计时长（秒）
+  double warmup = 1;     // 预热时长（秒）
+};
+
+bool parse_args(int argc, char* argv[], Config& cfg)
+{
+  std::map<std::string, std::string> args;
+  for (int i = 1; i + 1 < argc; i += 2)
+  {
+    if (std::strncmp(argv[i], "--", 2) != 0) return false;
+    args[argv[i] + 2] = argv[i + 1];
+  }
+  if (argc % 2 == 0) return false;
+
+  for (const auto& kv : args)
+  {
+    const std::string& k = kv.first;
+    const char* v = kv.second.c_str();
+    if (k == "host")
+      cfg.host = v;
+    else if (k == "port")
+      cfg.port = v;
+    else if (k == "mode" && (kv.second == "echo" || kv.second == "connect"))
+      cfg.connect_mode = kv.second == "connect";
+    else if (k == "clients")
+      cfg.clients = std::atoi(v);
+    else if (k == "threads")
+      cfg.threads = std::atoi(v);
+    else if (k == "rate")
+      cfg.rate = std::atof(v);
+    else if (k == "pipeline")
+      cfg.pipeline = std::atoi(v);
+    else if (k == "size")
+      cfg.size = static_cast<std::size_t>(std::atol(v));
+    else if (k == "size-max")
+      cfg.size_max = static_cast<std::size_t>(std::atol(v));
+    else if (k == "duration")
+      cfg.duration = std::atof(v);
+    else if (k == "warmup")
+      cfg.warmup = std::atof(v);
+    else
+      return false;
+  }
+  cfg.clients = std::max(cfg.clients, 1);
+  cfg.threads = std::max(std::min(cfg.threads, cfg.clients), 1);
+  cfg.pipeline = std::max(cfg.pipeline, 1);
+  cfg.size = std::max(cfg.size, kStampSize);
+  return true;
+}
+
+void put_stamp(char* p, std::uint64_t ns)
+{
+  for (std::size_t i = 0; i < kStampSize; ++i) p[i] = static_cast<char>((ns >> (8 * i)) & 0xff);
+}
+
+std::uint64_t get_stamp(const unsigned char* p)
+{
+  std::uint64_t ns = 0;
+  for (std::size_t i = 0; i < kStampSize; ++i) ns |= static_cast<std::uint64_t>(p[i]) << (8 * i);
+  return ns;
+}
+
+// 全局运行状态，由主线程推进
+struct Shared
+{
+  std::atomic<std::uint64_t> measure_begin_ns{~std::uint64_t(0)};  // 统计起点，之前计划发送的消息不计入
+  std::atomic<bool> sending{true};                                   // 是否继续发送
+  std::atomic<int> connected{0};
+};
+
+// 每个线程一个 Worker: 独立的 io_context、直方图和计数器，避免线程间争用
+class Worker
+{
+ public:
+  Worker(const Config& cfg, Shared& shared, unsigned seed) :
+    cfg_(cfg), shared_(shared), codec_(LengthPrefixCodec::Prefix::U32), rng_(seed), work_(asio::make_work_guard(io_))
+  {
+  }
+
+  void add_client()
+  {
+    if (cfg_.connect_mode)
+    {
+      add_churn_client();
+      return;
+    }
+    TcpClient::Options options;
+    options.no_delay = true;
+    auto client = std::make_shared<TcpClient>(io_, cfg_.host, cfg_.port, options);
+    client->set_frame_codec(std::make_shared<LengthPrefixCodec>(LengthPrefixCodec::Prefix::U32));
+
+    std::unique_ptr<Slot> slot(new Slot(io_));
+    slot->client = client;
+    Slot* s = slot.get();
+    client->set_status_callback([this, s](TcpClient::Status st, const std::string& info) {
+      if (st == TcpClient::Status::Connected)
+      {
+        if (s->was_connected) return;
+        s->was_connected = true;
+        ++shared_.connected;
+      }
+      else if (st == TcpClient::Status::Error)
+      {
+        std::cerr << "client: " << info << "\n";
+      }
+    });
+    client->set_message_view_callback([this, s](asio::const_buffer frame) { on_response(*s, frame); });
+    slots_.push_back(std::move(slot));
+    client->start();
+  }
+
+  // 所有客户端连上后开始发送
+  void start_load(std::uint64_t start_ns)
+  {
+    asio::post(io_, [this, start_ns] {
+      if (cfg_.connect_mode)
+      {
+        for (auto& c : churns_) churn(*c);
+      }
+      else if (cfg_.rate > 0)
+      {
+        std::uint64_t interval = static_cast<std::uint64_t>(1e9 * cfg_.clients / cfg_.rate);
+        std::uniform_int_distribution<std::uint64_t> phase(0, interval ? interval - 1 : 0);
+        for (auto& s : slots_)
+        {
+          s->interval_ns = std::max<std::uint64_t>(interval, 1);
+          s->next_ns = start_ns + phase(rng_);  // 随机相位，避免所有客户端同时发送
+          schedule(*s);
+        }
+      }
+      else
+      {
+        for (auto& s : slots_)
+        {
+          for (int i = 0; i < cfg_.pipeline; ++i) send_one(*s, TcpClientMetrics::now_ns());
+        }
+      }
+    });
+  }
+
+  void run()
+  {
+    io_.run();
+  }
+
+  void stop()
+  {
+    asio::post(io_, [this] {
+      for (auto& s : slots_)
+      {
+        s->timer.cancel();
+        s->client->stop();
+      }
+      for (auto& c : churns_)
+      {
+        std::error_code ec;
+        c->socket.close(ec);
+      }
+      work_.reset();
+    });
+  }
+
+  std::uint64_t sent() const
+  {
+    return sent_.load(std::memory_order_relaxed);
+  }
+
+  std::uint64_t received() const
+  {
+    return received_.load(std::memory_order_relaxed);
+  }
+
+  std::uint64_t received_bytes() const
+  {
+    return received_bytes_.load(std::memory_order_relaxed);
+  }
+
+  std::uint64_t failed() const
+  {
+    return failed_.load(std::memory_order_relaxed);
+  }
+
+  LatencyHistogram::Snapshot latency() const
+  {
+    return latency_.snapshot();
+  }
+
+ private:
+  struct Slot
+  {
+    explicit Slot(asio::io_context& io) : timer(io) {}
+
+    std::shared_ptr<TcpClient> client;
+    asio::steady_timer timer;
+    std::uint64_t interval_ns = 0;
+    std::uint64_t next_ns = 0;
+    bool was_connected = false;
+  };
+
+  // 建连模式的一个客户端: 同一时刻只有一条连接
+  struct ChurnSlot
+  {
+    explicit ChurnSlot(asio::io_context& io) : socket(io) {}
+
+    asio::ip::tcp::socket socket;
+    std::uint64_t started_ns = 0;  // 本次发起连接的时间
+    std::size_t bytes = 0;         // 本次连接读到的字节数
+    char buf[256];
+  };
+
+  // 建连模式: 解析一次地址，之后所有连接直接使用解析结果
+  void add_churn_client()
+  {
+    if (endpoints_.empty())
+    {
+      asio::ip::tcp::resolver resolver(io_);
+      std::error_code ec;
+      for (const auto& entry : resolver.resolve(cfg_.host, cfg_.port, ec)) endpoints_.push_back(entry.endpoint());
+      if (ec || endpoints_.empty())
+      {
+        std::cerr << "resolve " << cfg_.host << ":" << cfg_.port << " failed: " << ec.message() << "\n";
+        return;
+      }
+    }
+    churns_.emplace_back(new ChurnSlot(io_));
+    ++shared_.connected;  // 短连接没有常驻连接，创建即视为就绪
+  }
+
+  // 发起一次连接，读到 EOF 后记录延迟并立即开始下一次
+  void churn(ChurnSlot& c)
+  {
+    if (!shared_.sending.load(std::memory_order_relaxed)) return;
+    std::error_code ec;
+    c.socket.close(ec);
+    c.started_ns = TcpClientMetrics::now_ns();
+    c.bytes = 0;
+    sent_.fetch_add(1, std::memory_order_relaxed);
+    ChurnSlot* p = &c;
+    asio::async_connect(c.socket, endpoints_, [this, p](std::error_code ec, const asio::ip::tcp::endpoint&) {
+      if (ec)
+      {
+        on_churn_done(*p, ec);
+        return;
+      }
+      read_until_eof(*p);
+    });
+  }
+
+  void read_until_eof(ChurnSlot& c)
+  {
+    ChurnSlot* p = &c;
+    c.socket.async_read_some(asio::buffer(c.buf), [this, p](std::error_code ec, std::size_t n) {
+      p->bytes += n;
+      if (ec)
+      {
+        on_churn_done(*p, ec == asio::error::eof ? std::error_code() : ec);
+        return;
+      }
+      read_until_eof(*p);
+    });
+  }
+
+  void on_churn_done(ChurnSlot& c, const std::error_code& ec)
+  {
+    if (ec == asio::error::operation_aborted) return;  // stop() 关闭了套接字
+    if (ec)
+    {
+      failed_.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+      received_.fetch_add(1, std::memory_order_relaxed);
+      received_bytes_.fetch_add(c.bytes, std::memory_order_relaxed);
+      if (c.started_ns >= shared_.measure_begin_ns.load(std::memory_order_relaxed))
+        latency_.record(TcpClientMetrics::now_ns() - c.started_ns);
+    }
+    churn(c);
+  }
+
+  // 开环: 把计划时间已到的消息全部发出（落后时连续补发），再等到下一条的计划时间
+  void schedule(Slot& s)
+  {
+    if (!shared_.sending.load(std::memory_order_relaxed)) return;
+    std::uint64_t now = TcpClientMetrics::now_ns();
+    while (s.next_ns <= now)
+    {
+      send_one(s, s.next_ns);
+      s.next_ns += s.interval_ns;
+    }
+    s.timer.expires_after(std::chrono::nanoseconds(s.next_ns - now));
+    Slot* p = &s;
+    s.timer.async_wait([this, p](std::error_code ec) {
+      if (!ec) schedule(*p);
+    });
+  }
+
+  void send_one(Slot& s, std::uint64_t stamp_ns)
+  {
+    std::size_t size = cfg_.size;
+    if (cfg_.size_max > cfg_.size) size = std::uniform_int_distribution<std::size_t>(cfg_.size, cfg_.size_max)(rng_);
+    payload_.assign(size, 'x');
+    put_stamp(&payload_[0], stamp_ns);
+    std::string frame;
+    codec_.encode(payload_.data(), payload_.size(), frame);
+    if (s.client->send(std::move(frame))) sent_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void on_response(Slot& s, asio::const_buffer frame)
+  {
+    if (frame.size() < kStampSize) return;
+    std::uint64_t stamp = get_stamp(static_cast<const unsigned char*>(frame.data()));
+    std::uint64_t now = TcpClientMetrics::now_ns();
+    received_.fetch_add(1, std::memory_order_relaxed);
+    received_bytes_.fetch_add(frame.size(), std::memory_order_relaxed);
+    if (stamp >= shared_.measure_begin_ns.load(std::memory_order_relaxed)) latency_.record(now - stamp);
+    if (cfg_.rate <= 0 && shared_.sending.load(std::memory_order_relaxed)) send_one(s, now);
+  }
+
+  const Config& cfg_;
+  Shared& shared_;
+  LengthPrefixCodec codec_;
+  std::mt19937_64 rng_;
+  std::string payload_;
+  asio::io_context io_{1};
+  asio::executor_work_guard<asio::io_context::executor_type> work_;
+  std::vector<std::unique_ptr<Slot>> slots_;
+  std::vector<std::unique_ptr<ChurnSlot>> churns_;
+  std::vector<asio::ip::tcp::endpoint> endpoints_;  // 建连模式的目标地址
+  std::atomic<std::uint64_t> sent_{0};
+  std::atomic<std::uint64_t> received_{0};
+  std::atomic<std::uint64_t> received_bytes_{0};
+  std::atomic<std::uint64_t> failed_{0};  // 建连模式下失败的连接数
+  LatencyHistogram latency_;
+};
+
+// 合并各线程的直方图快照
+LatencyHistogram::Snapshot merge(const std::vector<std::unique_ptr<Worker>>& workers)
+{
+  LatencyHistogram::Snapshot total;
+  for (const auto& w : workers)
+  {
+    LatencyHistogram::Snapshot s = w->latency();
+    if (total.counts.size() < s.counts.size()) total.counts.resize(s.counts.size());
+    for (std::size_t i = 0; i < s.counts.size(); ++i) total.counts[i] += s.counts[i];
+    total.count += s.count;
+    total.sum += s.sum;
+    total.max = std::max(total.max, s.max);
+  }
+  return total;
+}
+
+std::string format_us(std::uint64_t ns)
+{
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(1) << ns / 1000.0 << "us";
+  return out.str();
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  Config cfg;
+  if (!parse_args(argc, argv, cfg))
+  {
+    std::cerr << "usage: tcp_loadgen [--host H] [--port P] [--mode echo|connect] [--clients N] [--threads M]\n"
+                 "                   [--rate R] [--pipeline K] [--size S] [--size-max S2]\n"
+                 "                   [--duration SEC] [--warmup SEC]\n";
+    return 1;
+  }
+
+  Shared shared;
+  std::vector<std::unique_ptr<Worker>> workers;
+  std::random_device rd;
+  for (int i = 0; i < cfg.threads; ++i) workers.emplace_back(new Worker(cfg, shared, rd()));
+  // Worker 内部的 io_context 只在本线程运行，先创建客户端再启动线程
+  for (int i = 0; i < cfg.clients; ++i) workers[i % cfg.threads]->add_client();
+
+  std::vector<std::thread> threads;
+  for (auto& w : workers)
+  {
+    Worker* p = w.get();
+    threads.emplace_back([p] { p->run(); });
+  }
+
+  using Clock = std::chrono::steady_clock;
+  Clock::time_point connect_deadline = Clock::now() + std::chrono::seconds(10);
+  while (shared.connected.load() < cfg.clients && Clock::now() < connect_deadline)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  if (shared.connected.load() < cfg.clients)
+  {
+    std::cerr << "only " << shared.connected.load() << "/" << cfg.clients << " clients connected\n";
+    for (auto& w : workers) w->stop();
+    for (auto& t : threads) t.join();
+    return 1;
+  }
+
+  const char* unit = cfg.connect_mode ? " conn/s" : " msg/s";
+  if (cfg.connect_mode)
+    std::cout << cfg.clients << " clients on " << cfg.threads << " thread(s), connect - read to EOF - close\n";
+  else
+    std::cout << cfg.clients << " clients on " << cfg.threads << " thread(s), "
+              << (cfg.rate > 0 ? "open loop at " + std::to_string(static_cast<long long>(cfg.rate)) + " msg/s"
+                               : "closed loop, pipeline " + std::to_string(cfg.pipeline))
+              << ", payload " << cfg.size << (cfg.size_max > cfg.size ? "-" + std::to_string(cfg.size_max) : "")
+              << " bytes\n";
+
+  std::uint64_t start_ns = TcpClientMetrics::now_ns();
+  for (auto& w : workers) w->start_load(start_ns);
+
+  std::uint64_t measure_begin = start_ns + static_cast<std::uint64_t>(cfg.warmup * 1e9);
+  std::uint64_t measure_end = measure_begin + static_cast<std::uint64_t>(cfg.duration * 1e9);
+  std::uint64_t recv_begin = 0, bytes_begin = 0, last_recv = 0;
+  bool measuring = false;
+  for (;;)
+  {
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    std::uint64_t now = TcpClientMetrics::now_ns();
+    std::uint64_t recv = 0, bytes = 0, sent = 0;
+    for (auto& w : workers)
+    {
+      recv += w->received();
+      bytes += w->received_bytes();
+      sent += w->sent() - w->failed();
+    }
+    // 本行统计的是上一秒，标签按上一秒所处阶段给出
+    const char* label = measuring ? "  " : "  (warmup) ";
+    if (!measuring && now >= measure_begin)
+    {
+      // 粗略对齐到 1s 打点，之后只统计计划发送时间不早于此刻的消息
+      measuring = true;
+      measure_begin = now;
+      measure_end = now + static_cast<std::uint64_t>(cfg.duration * 1e9);
+      shared.measure_begin_ns.store(now);
+      recv_begin = recv;
+      bytes_begin = bytes;
+    }
+    std::cout << label << recv - last_recv << unit << ", in flight " << sent - recv << "\n";
+    last_recv = recv;
+    if (measuring && now >= measure_end)
+    {
+      double seconds = (now - measure_begin) / 1e9;
+      shared.sending.store(false);
+      // 给在途消息一点时间返回
+      std::this_thread::sleep_for(std::chrono::milliseconds(500));
+      LatencyHistogram::Snapshot lat = merge(workers);
+      std::uint64_t unanswered = 0, failed = 0;
+      for (auto& w : workers)
+      {
+        failed += w->failed();
+        unanswered += w->sent() - w->received() - w->failed();
+      }
+
+      std::cout << "throughput: " << static_cast<std::uint64_t>((recv - recv_begin) / seconds) << unit << ", "
+                << std::fixed << std::setprecision(2) << (bytes - bytes_begin) / seconds / (1024 * 1024)
+                << " MiB/s payload\n";
+      std::cout << "latency (" << lat.count << " samples): p50 " << format_us(lat.percentile(0.5)) << ", p99 "
+                << format_us(lat.percentile(0.99)) << ", p99.9 " << format_us(lat.percentile(0.999)) << ", max "
+                << format_us(lat.max) << ", mean " << format_us(static_cast<std::uint64_t>(lat.mean())) << "\n";
+      if (unanswered) std::cout << "unanswered: " << unanswered << "\n";
+      if (failed) std::cout << "failed connects: " << failed << "\n";
+      break;
+    }
+  }
+
+  for (auto& w : workers) w->stop();
+  for (auto& t : threads) t.join();
+  return 0;
+}
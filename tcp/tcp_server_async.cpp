@@ -1,30 +1,50 @@
+/*
+  异步 daytime 服务器: 接受连接 - 写出当前时间 - 关闭
+  接受方式:
+  - 默认同时挂起 outstanding 个 async_accept，每完成一个立即补上一个，
+    连接突发到达时不必每个连接都等一轮 reactor 往返才重新发起接受，减少监听队列溢出
+  - drain 模式: 只等待监听套接字可读（async_wait），一次就绪后循环非阻塞 accept4 直到 EAGAIN，
+    一轮把监听队列中积压的连接全部取走（Linux 以外的平台用非阻塞 accept 代替 accept4）
+  用法: tcp_server_async [port=13] [outstanding=1] [drain=0]
+*/
+
 #include <asio.hpp>
+#include <cerrno>
+#include <cstdlib>
 #include <ctime>
 #include <functional>
 #include <iostream>
-#include <memory>
+#include <new>
 #include <string>
 
+#if defined(__linux__)
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "network/session_pool.h"
+
 using asio::ip::tcp;
 
-// 获取当前日期和时间的字符串
-std::string make_daytime_string()
+// 获取当前日期和时间的字符串（写入 out，复用其已有容量）
+void make_daytime_string(std::string& out)
 {
-  using namespace std;   // For time_t, time and ctime;
-  time_t now = time(0);  // 获取当前时间
-  return ctime(&now);    // 转换为字符串
+  using namespace std;      // For time_t, time and ctime;
+  time_t now = time(0);     // 获取当前时间
+  out.assign(ctime(&now));  // 转换为字符串
 }
 
 // TCP 连接类，管理与客户端的连接
-class tcp_connection : public std::enable_shared_from_this<tcp_connection>  // 支持从自身获取 shared_ptr
+// 连接对象由 tcp_server 的会话池分配: 引用计数（非原子）归零时关闭 socket 并放回池中，
+// 下一个连接复用同一个对象和 socket，短连接不再为每个连接 new/delete 一次
+class tcp_connection : public PooledSession<tcp_connection>  // 支持从自身获取 SessionRef
 {
  public:
-  typedef std::shared_ptr<tcp_connection> pointer;
+  typedef SessionRef<tcp_connection> pointer;
 
-  // 创建一个新的 tcp_connection 实例
-  static pointer create(asio::io_context& io_context)
+  // 由会话池在 slab 上就地构造
+  explicit tcp_connection(asio::io_context& io_context) : socket_(io_context)  // 初始化 socket
   {
-    return pointer(new tcp_connection(io_context));
   }
 
   // 返回 socket，用于与客户端通信
@@ -36,20 +56,22 @@ class tcp_connection : public std::enable_shared_from_this<tcp_connection>  // 
   // 启动连接，发送当前时间给客户端
   void start()
   {
-    message_ = make_daytime_string();  // 获取当前时间字符串
+    make_daytime_string(message_);  // 获取当前时间字符串
 
     // 异步写数据到客户端
     asio::async_write(socket_, asio::buffer(message_),
-                      std::bind(&tcp_connection::handle_write, shared_from_this(), asio::placeholders::error,
+                      std::bind(&tcp_connection::handle_write, self(), asio::placeholders::error,
                                 asio::placeholders::bytes_transferred));
   }
 
- private:
-  // 私有构造函数，只能通过 create() 创建实例
-  tcp_connection(asio::io_context& io_context) : socket_(io_context)  // 初始化 socket
+  // 回收到池中时调用: 关闭连接，socket 对象留给下一个连接使用
+  void reset()
   {
+    std::error_code ec;
+    socket_.close(ec);
   }
 
+ private:
   // 异步写完成后的回调函数
   void handle_write(const std::error_code& /*error*/, size_t /*bytes_transferred*/)
   {
@@ -64,19 +86,46 @@ class tcp_connection : public std::enable_shared_from_this<tcp_connection>  // 
 class tcp_server
 {
  public:
-  // 构造函数，初始化服务器并开始监听 13 端口
-  tcp_server(asio::io_context& io_context) :
-    io_context_(io_context), acceptor_(io_context, tcp::endpoint(tcp::v4(), 13))  // 监听端口 13
+  // 一次就绪后最多连续接受的连接数，防止连接洪峰时接受循环长时间占用线程，饿死已接受连接上的写操作
+  static const int kMaxDrainBatch = 256;
+
+  // 构造函数，初始化服务器并开始监听 port 端口
+  // outstanding: 同时挂起的异步接受数；drain: 改用 "等待可读 + 循环非阻塞接受" 的方式
+  tcp_server(asio::io_context& io_context, unsigned short port = 13, int outstanding = 1, bool drain = false) :
+    io_context_(io_context),
+    pool_(64, [&io_context](void* p) { return new (p) tcp_connection(io_context); }),  // 每个 slab 64 个连接
+    acceptor_(io_context, tcp::endpoint(tcp::v4(), port))                               // 监听端口
   {
-    start_accept();  // 启动接受连接的操作
+    if (drain)
+    {
+      acceptor_.non_blocking(true);  // 同步 accept 在队列为空时返回 would_block 而不是阻塞
+      start_wait();
+    }
+    else
+    {
+      for (int i = 0; i < (outstanding > 0 ? outstanding : 1); ++i) start_accept();  // 启动接受连接的操作
+    }
+  }
+
+  // 池先于 io_context 析构（例如 run() 因异常退出）时，挂起的处理函数仍持有 SessionRef:
+  // 关闭接受器和所有连接，运行被取消的处理函数，释放全部引用后再析构池
+  ~tcp_server()
+  {
+    std::error_code ec;
+    acceptor_.close(ec);
+    pool_.for_each([](tcp_connection& c) { c.reset(); });
+    io_context_.restart();
+    while (pool_.in_use() > 0 && io_context_.poll_one() > 0)
+    {
+    }
   }
 
  private:
-  // 启动异步接受连接
+  // 启动异步接受连接（每个挂起的接受各自占用一个连接对象）
   void start_accept()
   {
-    // 创建一个新的连接对象
-    tcp_connection::pointer new_connection = tcp_connection::create(io_context_);
+    // 从会话池取出一个连接对象（优先复用已关闭的连接）
+    tcp_connection::pointer new_connection = pool_.acquire();
 
     // 异步接受连接
     acceptor_.async_accept(new_connection->socket(),
@@ -91,21 +140,74 @@ class tcp_server
       new_connection->start();
     }
 
-    // 继续接受下一个连接
-    start_accept();
+    // 继续接受下一个连接（接受器已关闭时不再补充）
+    if (error != asio::error::operation_aborted && acceptor_.is_open()) start_accept();
   }
 
-  asio::io_context& io_context_;  // io_context 用于驱动异步操作
-  tcp::acceptor acceptor_;        // 用于接受客户端连接的 acceptor
+  // drain 模式: 等待监听套接字可读
+  void start_wait()
+  {
+    acceptor_.async_wait(tcp::acceptor::wait_read,
+                         std::bind(&tcp_server::handle_wait, this, asio::placeholders::error));
+  }
+
+  // drain 模式: 一次就绪后循环接受，直到队列为空（或达到单轮上限），再重新等待
+  void handle_wait(const std::error_code& error)
+  {
+    if (error == asio::error::operation_aborted || !acceptor_.is_open()) return;
+    for (int i = 0; i < kMaxDrainBatch; ++i)
+    {
+      tcp_connection::pointer new_connection = pool_.acquire();
+      std::error_code ec;
+      if (!accept_one(new_connection->socket(), ec))
+      {
+        if (ec == asio::error::would_block || ec == asio::error::try_again) break;  // 队列已取空
+        if (ec == asio::error::connection_aborted || ec == asio::error::interrupted) continue;
+        // 文件描述符耗尽等错误: 留待下一次就绪再试，避免空转
+        std::cerr << "accept: " << ec.message() << std::endl;
+        break;
+      }
+      new_connection->start();
+    }
+    start_wait();
+  }
+
+  // 非阻塞接受一个连接，成功时 socket 接管新连接
+  bool accept_one(tcp::socket& socket, std::error_code& ec)
+  {
+#if defined(__linux__)
+    // accept4 一次系统调用同时设置 O_NONBLOCK 和 FD_CLOEXEC
+    int fd = ::accept4(acceptor_.native_handle(), nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0)
+    {
+      ec = std::error_code(errno, asio::error::get_system_category());
+      return false;
+    }
+    socket.assign(tcp::v4(), fd, ec);
+    if (ec) ::close(fd);
+    return !ec;
+#else
+    acceptor_.accept(socket, ec);
+    return !ec;
+#endif
+  }
+
+  asio::io_context& io_context_;      // io_context 用于驱动异步操作
+  SessionPool<tcp_connection> pool_;  // 连接对象池，与 io_context 同在一个线程
+  tcp::acceptor acceptor_;            // 用于接受客户端连接的 acceptor
 };
 
-int main()
+int main(int argc, char* argv[])
 {
   try
   {
-    asio::io_context io_context;    // 创建 io_context，处理异步事件
-    tcp_server server(io_context);  // 创建 TCP 服务器
-    io_context.run();               // 启动事件循环，处理异步操作
+    unsigned short port = static_cast<unsigned short>(argc > 1 ? std::atoi(argv[1]) : 13);
+    int outstanding = argc > 2 ? std::atoi(argv[2]) : 1;
+    bool drain = argc > 3 && std::atoi(argv[3]) != 0;
+
+    asio::io_context io_context(1);                           // 创建 io_context，处理异步事件（单线程运行）
+    tcp_server server(io_context, port, outstanding, drain);  // 创建 TCP 服务器
+    io_context.run();                                         // 启动事件循环，处理异步操作
   }
   catch (std::exception& e)
   {
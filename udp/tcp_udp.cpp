@@ -4,8 +4,11 @@
 #include <functional>
 #include <iostream>
 #include <memory>
+#include <new>
 #include <string>
 
+#include "network/session_pool.h"
+
 using asio::ip::tcp;
 using asio::ip::udp;
 
@@ -18,16 +21,14 @@ std::string make_daytime_string()
 }
 
 // 表示一个 TCP 连接，负责发送 daytime 消息
-class tcp_connection : public std::enable_shared_from_this<tcp_connection>
+// 连接对象由 tcp_server 的会话池分配，引用计数（非原子）归零时关闭 socket 并放回池中供下一个连接复用
+class tcp_connection : public PooledSession<tcp_connection>
 {
  public:
-  typedef std::shared_ptr<tcp_connection> pointer;  // 定义智能指针类型
+  typedef SessionRef<tcp_connection> pointer;  // 侵入式引用，复制时只做非原子加一
 
-  // 工厂函数，创建一个 tcp_connection 实例
-  static pointer create(asio::io_context& io_context)
-  {
-    return pointer(new tcp_connection(io_context));
-  }
+  // 由会话池在 slab 上就地构造，初始化 socket
+  explicit tcp_connection(asio::io_context& io_context) : socket_(io_context) {}
 
   // 获取底层 socket 引用
   tcp::socket& socket()
@@ -38,16 +39,20 @@ class tcp_connection : public std::enable_shared_from_this<tcp_connection>
   // 启动连接，发送 daytime 消息
   void start()
   {
-    message_ = make_daytime_string();  // 生成要发送的时间字符串
+    message_.assign(make_daytime_string());  // 生成要发送的时间字符串（复用上一个连接留下的容量）
 
     // 异步写入消息到 socket
-    asio::async_write(socket_, asio::buffer(message_), std::bind(&tcp_connection::handle_write, shared_from_this()));
+    asio::async_write(socket_, asio::buffer(message_), std::bind(&tcp_connection::handle_write, self()));
   }
 
- private:
-  // 构造函数，初始化 socket
-  tcp_connection(asio::io_context& io_context) : socket_(io_context) {}
+  // 回收到池中时调用: 关闭连接，socket 对象留给下一个连接
+  void reset()
+  {
+    std::error_code ec;
+    socket_.close(ec);
+  }
 
+ private:
   // 异步写完成后的处理（这里暂时不做任何事）
   void handle_write() {}
 
@@ -61,16 +66,31 @@ class tcp_server
  public:
   // 构造，初始化 acceptor 监听本地 13 端口
   tcp_server(asio::io_context& io_context) :
-    io_context_(io_context), acceptor_(io_context, tcp::endpoint(tcp::v4(), 13))
+    io_context_(io_context),
+    pool_(64, [&io_context](void* p) { return new (p) tcp_connection(io_context); }),
+    acceptor_(io_context, tcp::endpoint(tcp::v4(), 13))
   {
     start_accept();  // 启动第一次异步接受连接
   }
 
+  // 池先于 io_context 析构（例如 run() 因异常退出）时，挂起的处理函数仍持有 SessionRef:
+  // 关闭接受器和所有连接，运行被取消的处理函数，释放全部引用后再析构池
+  ~tcp_server()
+  {
+    std::error_code ec;
+    acceptor_.close(ec);
+    pool_.for_each([](tcp_connection& c) { c.reset(); });
+    io_context_.restart();
+    while (pool_.in_use() > 0 && io_context_.poll_one() > 0)
+    {
+    }
+  }
+
  private:
   // 启动异步接受新连接
   void start_accept()
   {
-    tcp_connection::pointer new_connection = tcp_connection::create(io_context_);
+    tcp_connection::pointer new_connection = pool_.acquire();  // 优先复用已关闭的连接对象
 
     acceptor_.async_accept(new_connection->socket(),
                            std::bind(&tcp_server::handle_accept, this, new_connection, asio::placeholders::error));
@@ -84,11 +104,12 @@ class tcp_server
       new_connection->start();  // 启动连接（发送消息）
     }
 
-    start_accept();  // 继续等待下一个连接
+    if (acceptor_.is_open()) start_accept();  // 继续等待下一个连接（接受器已关闭时不再补充）
   }
 
-  asio::io_context& io_context_;  // 引用 io_context
-  tcp::acceptor acceptor_;        // TCP 连接接受器
+  asio::io_context& io_context_;      // 引用 io_context
+  SessionPool<tcp_connection> pool_;  // 连接对象池（每个 slab 64 个），与 io_context 同在一个线程
+  tcp::acceptor acceptor_;            // TCP 连接接受器
 };
 
 // UDP 服务器，监听端口并响应请求
@@ -1,11 +1,21 @@
+/*
+  异步 UDP daytime 服务器: 收到任意数据报后回复当前时间
+  - 默认每个数据报一次 async_receive_from、一次 async_send_to
+  - batch > 0 时使用 UdpBatchSocket: 一次 recvmmsg 最多收 batch 个请求，回复排队后用一次 sendmmsg 发出
+  用法: udp_server_async [port=13] [batch=0]
+*/
+
 #include <array>
 #include <asio.hpp>
+#include <cstdlib>
 #include <ctime>
 #include <functional>
 #include <iostream>
 #include <memory>
 #include <string>
 
+#include "network/udp_batch_socket.h"
+
 using asio::ip::udp;
 
 // 生成当前时间的字符串
@@ -20,8 +30,9 @@ std::string make_daytime_string()
 class udp_server
 {
  public:
-  // 构造函数，初始化 socket 并绑定到本地13号端口
-  udp_server(asio::io_context& io_context) : socket_(io_context, udp::endpoint(udp::v4(), 13))
+  // 构造函数，初始化 socket 并绑定到本地 port 端口
+  udp_server(asio::io_context& io_context, unsigned short port = 13) :
+    socket_(io_context, udp::endpoint(udp::v4(), port))
   {
     start_receive();  // 启动第一次异步接收
   }
@@ -67,15 +78,49 @@ class udp_server
   std::array<char, 1> recv_buffer_;  // 接收缓冲区（这里只需要一点数据触发即可）
 };
 
-int main()
+// 批量模式的 UDP 服务器: 一批请求的回复在接收回调返回后一次发出
+class udp_batch_server
+{
+ public:
+  udp_batch_server(asio::io_context& io_context, unsigned short port, std::size_t batch) :
+    socket_(io_context, udp::endpoint(udp::v4(), port), make_options(batch))
+  {
+    socket_.start([this](const UdpBatchSocket::Datagram* datagrams, std::size_t count) {
+      message_ = make_daytime_string();  // 同一批请求共用一个时间字符串
+      for (std::size_t i = 0; i < count; ++i) socket_.send_to(asio::buffer(message_), datagrams[i].remote);
+    });
+  }
+
+ private:
+  static UdpBatchSocket::Options make_options(std::size_t batch)
+  {
+    UdpBatchSocket::Options options;
+    options.batch_size = batch;
+    options.max_datagram_size = 64;  // 请求内容不关心，回复是一行时间字符串
+    return options;
+  }
+
+  UdpBatchSocket socket_;  // 批量收发的 UDP socket
+  std::string message_;    // 本批回复的内容
+};
+
+int main(int argc, char* argv[])
 {
   try
   {
+    unsigned short port = static_cast<unsigned short>(argc > 1 ? std::atoi(argv[1]) : 13);
+    std::size_t batch = argc > 2 ? static_cast<std::size_t>(std::atoi(argv[2])) : 0;
+
     // 创建 io_context，管理异步操作
-    asio::io_context io_context;
+    asio::io_context io_context(1);
 
-    // 创建并运行UDP服务器
-    udp_server server(io_context);
+    // 创建并运行UDP服务器（batch 为 0 时逐个收发）
+    std::unique_ptr<udp_server> server;
+    std::unique_ptr<udp_batch_server> batch_server;
+    if (batch > 0)
+      batch_server.reset(new udp_batch_server(io_context, port, batch));
+    else
+      server.reset(new udp_server(io_context, port));
 
     // 运行事件循环，处理所有异步事件
     io_context.run();